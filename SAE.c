@@ -1,222 +1,480 @@
 /**
  * \file SAE.c
- * \brief Fichier contenant les fonctions du programme de gestion des stages.
+ * \brief Interface en mode texte de la gestion des stages : menus, saisies et affichages.
  * \authors MIOTTO Quentin, PICHOT-MOÏSE Mathéo
  * \date 15 Octobre 2024
  */
 #include "SAE.h"
 
+// Enregistrement et rejeu des saisies
+static int modeSaisie = SAISIE_NORMALE;
+static FILE *flotSaisie = NULL;
+static double debutSession = 0; // Instant du début de la session (ms)
+static double finDerniereSaisie = -1; // Instant où la dernière saisie a été rendue (ms)
+static long nbSaisies = 0;
+static double latenceTotale = 0, latenceMax = 0; // Temps de traitement entre deux saisies (ms)
+
+// Affichage paginé
+static char tamponSortie[TAILLE_TAMPON]; // Tampon partagé par les listes (une seule à la fois)
 
 /**
- * \brief Remplit les tableaux avec les informations des offres de stages à partir du fichier "offrestage.don".
+ * \brief Donne l'instant courant en millisecondes (horloge monotone).
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tlog Taille logique du tableau.
- * \param tmax Taille physique du tableau.
- * \return 0 si tout s'est bien passé, -1 en cas d'erreur de lecture.
+ * \return L'instant courant.
  */
-int remplirOffreStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog, int tmax) {
-    FILE *flot;
-    int ref, dept, pourvu, candid, etu1, etu2, etu3;
-    int i=0;
+double maintenant(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000.0 + t.tv_nsec / 1e6;
+}
 
-    flot = fopen("DATA/offrestage.don", "r");
-    
-    if (flot  == NULL) return -1; // Erreur lors du chargement
-    
-    while(i < tmax && fscanf(flot, "%d", &ref) == 1) {
-        if (ref >= 1000) {
-            tRef[i] = ref;
-            if (fscanf(flot, "%d%d%d", &dept, &pourvu, &candid) != 3) {
-                break;
-            }
+/**
+ * \brief Enregistre désormais chaque saisie, avec son instant, dans un fichier.
+ * 
+ * Le fichier commence par la version du format : les saisies sont des numéros
+ * de menu, qui n'ont plus le même sens si les menus changent.
+ * 
+ * \param chemin Fichier d'enregistrement.
+ * \return 1 si tout s'est bien passé, -1 en cas d'erreur d'ouverture.
+ */
+int demarrerEnregistrement(const char *chemin) {
+    flotSaisie = fopen(chemin, "w");
+    if (flotSaisie == NULL) return -1; // Problème ouverture fichier
+    fprintf(flotSaisie, "SAISIES %d\n", VERSION_SAISIES);
+    modeSaisie = SAISIE_ENREGISTREMENT;
+    debutSession = maintenant();
+    return 1; // Fonction réussi
+}
 
-            if (candid==3) {
-                if (fscanf(flot, "%d%d%d", &etu1, &etu2, &etu3) != 3) {
-                    break;
-                }
-            }
-            else if (candid==2) {
-                if (fscanf(flot, "%d%d", &etu1, &etu2) != 2) {
-                    break;
-                }
-                etu3=0;
+/**
+ * \brief Lit désormais les saisies dans un enregistrement au lieu du clavier.
+ * 
+ * \param chemin Fichier d'enregistrement.
+ * \param vitesseMax 1 pour enchaîner les saisies sans attendre, 0 pour respecter leurs instants.
+ * \return 1 si tout s'est bien passé, -1 en cas d'erreur d'ouverture, -2 si l'enregistrement
+ * n'a pas la version courante des menus.
+ */
+int demarrerRejeu(const char *chemin, int vitesseMax) {
+    int versionLue;
+
+    flotSaisie = fopen(chemin, "r");
+    if (flotSaisie == NULL) return -1; // Problème ouverture fichier
+    if (fscanf(flotSaisie, "SAISIES %d", &versionLue) != 1 || versionLue != VERSION_SAISIES) {
+        fclose(flotSaisie);
+        flotSaisie = NULL;
+        return -2; // Menus différents : les saisies n'auraient plus le même sens
+    }
+    modeSaisie = vitesseMax == 1 ? SAISIE_REJEU_MAX : SAISIE_REJEU;
+    debutSession = maintenant();
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Indique si un texte saisi est un entier ou un réel complet.
+ * 
+ * \param type 'i' pour un entier, 'f' pour un réel, 't' pour une ligne de texte (toujours valide).
+ * \param texte Texte de la saisie.
+ * \return 1 si le texte est valide, 0 sinon (caractères en trop, valeur hors limites).
+ */
+int saisieValide(char type, const char texte[]) {
+    char *fin;
+    long valeur;
+
+    if (type == 't') return 1;
+    errno = 0;
+    if (type == 'i') {
+        valeur = strtol(texte, &fin, 10);
+        if (valeur < INT_MIN || valeur > INT_MAX) return 0;
+    }
+    else strtof(texte, &fin);
+    return fin != texte && *fin == '\0' && errno == 0;
+}
+
+/**
+ * \brief Lit une saisie (clavier ou enregistrement) sous forme de texte.
+ * 
+ * Au clavier, une saisie invalide ("12abc" pour un entier) est refusée en entier
+ * et redemandée. En rejeu, attend si besoin l'instant enregistré et mesure le temps
+ * de traitement écoulé depuis la saisie précédente.
+ * 
+ * \param type 'i' pour un entier, 'f' pour un réel, 't' pour une ligne de texte.
+ * \param texte Texte de la saisie (au moins 64 caractères).
+ * \return 1 quand une saisie valide a été lue (le programme se termine s'il n'y en a plus).
+ */
+int lireSaisie(char type, char texte[]) {
+    double instant, attente, t = maintenant();
+    char typeLu;
+    int code, suivant, trop;
+
+    if (finDerniereSaisie >= 0) { // Traitement de la saisie précédente terminé
+        double latence = t - finDerniereSaisie;
+        latenceTotale += latence;
+        if (latence > latenceMax) latenceMax = latence;
+    }
+
+    if (modeSaisie == SAISIE_REJEU || modeSaisie == SAISIE_REJEU_MAX) {
+        if (fscanf(flotSaisie, "%lf %c %63[^\n]", &instant, &typeLu, texte) != 3) {
+            terminerSaisies();
+            exit(0); // Enregistrement épuisé
+        }
+        attente = debutSession + instant - maintenant();
+        if (modeSaisie == SAISIE_REJEU && attente > 0) usleep((useconds_t)(attente * 1000));
+        if (typeLu != type || saisieValide(type, texte) == 0) {
+            fprintf(stderr, "\nEnregistrement invalide : saisie %ld inattendue.\n", nbSaisies + 1);
+            terminerSaisies();
+            exit(1); // Les saisies suivantes seraient décalées
+        }
+    }
+    else {
+        do {
+            if (type == 't') {
+                code = scanf(" %63[^\n]", texte);
+                if (code == 1) while ((suivant = getchar()) != EOF && suivant != '\n'); // Fin de ligne trop longue ignorée
             }
-            else if  (candid==1) {
-                if (fscanf(flot, "%d", &etu1) != 1) {
-                    break;
+            else {
+                code = scanf(" %63s", texte);
+                if (code == 1) {
+                    trop = 0;
+                    while ((suivant = getchar()) != EOF && !isspace(suivant)) trop = 1; // Texte trop long : reste ignoré
+                    if (trop == 1 || saisieValide(type, texte) == 0) {
+                        printf("Saisie invalide, recommencez : ");
+                        code = 0;
+                    }
                 }
-                etu2=0; 
-                etu3=0;
             }
-            else {
-                etu1=0;
-                etu2=0;
-                etu3=0;
+            if (code == EOF) {
+                terminerSaisies();
+                exit(0); // Plus aucune saisie possible
             }
-            
-            tDpt[i] = dept;
-            tPourvu[i] = pourvu;
-            tCandid[i] = candid;
-            tEtu1[i] = etu1;
-            tEtu2[i] = etu2;
-            tEtu3[i] = etu3;
-
-            i++;
-            (*tlog)++;
+        } while (code != 1);
+        if (modeSaisie == SAISIE_ENREGISTREMENT) {
+            fprintf(flotSaisie, "%.3f %c %s\n", maintenant() - debutSession, type, texte);
+            fflush(flotSaisie);
         }
     }
-    fclose(flot);
+
+    nbSaisies++;
+    finDerniereSaisie = maintenant();
     return 1; // Fonction réussi
 }
 
 /**
- * \brief Remplit les tableaux avec les informations des étudiants à partir d'un fichier.
+ * \brief Lit un entier au clavier, ou dans l'enregistrement en cours de rejeu.
  * 
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tRefStage[] Tableau des références de stages associés aux étudiants.
- * \param tNoteFinal[] Tableau des moyennes finales des étudiants.
- * \param tlog Taille logique du tableau.
- * \param tmax Taille physique du tableau.
- * \return 0 si tout s'est bien passé, -1 ou -2 en cas d'erreur de lecture.
+ * \param val Entier lu, 0 si aucun entier valide n'a été lu.
+ * \return 1 si un entier a été lu, 0 sinon.
  */
-int remplirListeEtudiants(int tNumEtu[], int tRefStage[], float tNoteFinal[], int *tlog, int tmax) {
-    int i=0, num, ref;
-    float note;
-    FILE *flot;
-    flot = fopen("DATA/etudiants.don", "r");
-
-    if (flot == NULL) return -1; // Erreur lors du chargement
-
-    fscanf(flot, "%d %d %f", &num, &ref, &note);
-    while(!feof(flot)) {
-        if (i < tmax) {
-            tNumEtu[i] = num;
-            tRefStage[i] = ref;
-            tNoteFinal[i] = note;
-            (*tlog)++;
-            i++;
-            fscanf(flot,"%d%d%f", &num, &ref, &note);
-        }
-        else {
-            fclose(flot);
-            return -2; 
+int lireEntier(int *val) {
+    char texte[64];
+    *val = 0;
+    if (lireSaisie('i', texte) == 0) return 0;
+    *val = atoi(texte);
+    return 1;
+}
+
+/**
+ * \brief Lit un réel au clavier, ou dans l'enregistrement en cours de rejeu.
+ * 
+ * \param val Réel lu, 0 si aucun réel valide n'a été lu.
+ * \return 1 si un réel a été lu, 0 sinon.
+ */
+int lireReel(float *val) {
+    char texte[64];
+    *val = 0;
+    if (lireSaisie('f', texte) == 0) return 0;
+    *val = strtof(texte, NULL);
+    return 1;
+}
+
+/**
+ * \brief Lit une ligne de texte au clavier, ou dans l'enregistrement en cours de rejeu.
+ * 
+ * \param texte Ligne lue (au moins 64 caractères).
+ * \return 1 si une ligne a été lue, 0 sinon.
+ */
+int lireTexte(char texte[]) {
+    return lireSaisie('t', texte);
+}
+
+/**
+ * \brief Termine l'enregistrement ou le rejeu et affiche le bilan d'un rejeu.
+ * 
+ * Le bilan est écrit sur la sortie d'erreur : nombre de saisies, débit et
+ * temps de traitement moyen et maximal entre deux saisies.
+ */
+void terminerSaisies(void) {
+    double duree = maintenant() - debutSession;
+
+    if (modeSaisie == SAISIE_REJEU || modeSaisie == SAISIE_REJEU_MAX) {
+        fprintf(stderr, "\nRejeu : %ld saisie(s) en %.1f ms", nbSaisies, duree);
+        if (duree > 0) fprintf(stderr, ", %.1f saisie(s)/s", nbSaisies * 1000.0 / duree);
+        if (nbSaisies > 1) fprintf(stderr, ", traitement moyen %.3f ms, max %.3f ms", latenceTotale / (nbSaisies - 1), latenceMax);
+        fprintf(stderr, "\n");
+    }
+    if (flotSaisie != NULL) fclose(flotSaisie);
+    flotSaisie = NULL;
+    modeSaisie = SAISIE_NORMALE;
+}
+
+/**
+ * \brief Rejoue plusieurs enregistrements en même temps, chacun dans son propre processus.
+ * 
+ * Simule plusieurs utilisateurs travaillant en parallèle sur le même dossier DATA.
+ * Chaque processus affiche son propre bilan ; la durée totale est affichée à la fin.
+ * 
+ * \param nb Nombre d'enregistrements.
+ * \param tChemins[] Fichiers d'enregistrement.
+ * \param vitesseMax 1 pour enchaîner les saisies sans attendre, 0 pour respecter leurs instants.
+ * \return 1 si tous les rejeux se sont bien terminés, -1 sinon.
+ */
+int rejouerPlusieurs(int nb, char *tChemins[], int vitesseMax) {
+    double debut = maintenant();
+    int etat, code = 1;
+    pid_t pid;
+
+    for (int i = 0; i < nb; i++) {
+        pid = fork();
+        if (pid == -1) return -1; // Impossible de créer le processus
+        if (pid == 0) {
+            if (freopen("/dev/null", "w", stdout) == NULL) exit(1); // Seuls les bilans sont affichés
+            if (demarrerRejeu(tChemins[i], vitesseMax) != 1) exit(1);
+            global();
+            terminerSaisies();
+            exit(0);
         }
     }
-    fclose(flot);
-    return 1; // Fonction réussi
+    for (int i = 0; i < nb; i++) {
+        if (wait(&etat) == -1 || !WIFEXITED(etat) || WEXITSTATUS(etat) != 0) code = -1;
+    }
+    fprintf(stderr, "\n%d rejeu(x) simultané(s) terminé(s) en %.1f ms\n", nb, maintenant() - debut);
+    return code;
 }
 
 
 /**
- * \brief Sauvegarde les modifications apportées aux stages et aux étudiants dans un fichier.
+ * \brief Initialise un tampon de liste paginée.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tlogOffre Taille logique du tableau des offres de stages.
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tRefStage[] Tableau des références de stages associés aux étudiants.
- * \param tNoteFinal[] Tableau des moyennes finales des étudiants.
- * \param tlogEtu Taille logique du tableau d'étudiants.
- * \return 1 si la sauvegarde s'est bien effectuée, -1 en cas d'erreur.
+ * \param p Page à initialiser.
  */
-int modificationFichier(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog, int tNumEtu[], int tRefStage[], float tNoteFinal[], int *tlogEtu) {
-    FILE *flot;
-    flot = fopen("DATA/offrestage.don", "w");
-    if (flot == NULL) return -1;
-
-    for (int i = 0; i < *tlog; i++) {
-        fprintf(flot, "\n%d %d\n%d\n%d", tRef[i], tDpt[i], tPourvu[i], tCandid[i]);
-        if (tPourvu[i] == 0) {
-            if (tCandid[i] == 3) fprintf(flot, "\n%d\n%d\n%d", tEtu1[i], tEtu2[i], tEtu3[i]);
-            else if (tCandid[i] == 2) fprintf(flot, "\n%d\n%d", tEtu1[i], tEtu2[i]);
-            else if (tCandid[i] == 1) fprintf(flot, "\n%d", tEtu1[i]);
-        }
+void pageInit(Page *p) {
+    p->tampon = tamponSortie;
+    p->lg = 0;
+    p->lignes = 0;
+}
+
+/**
+ * \brief Écrit en une seule fois le contenu du tampon sur la sortie standard.
+ * 
+ * \param p Page à vider.
+ */
+void pageVider(Page *p) {
+    if (p->lg > 0) fwrite(p->tampon, 1, p->lg, stdout);
+    fflush(stdout);
+    p->lg = 0;
+}
+
+/**
+ * \brief Ajoute du texte formaté au tampon, qui est vidé s'il est plein.
+ * 
+ * \param p Page à compléter.
+ * \param format Format au sens de printf.
+ */
+void pageAjouter(Page *p, const char *format, ...) {
+    va_list args;
+    int n;
+
+    va_start(args, format);
+    n = vsnprintf(p->tampon + p->lg, TAILLE_TAMPON - p->lg, format, args);
+    va_end(args);
+
+    if (n >= TAILLE_TAMPON - p->lg) { // Plus de place : on vide puis on recommence
+        pageVider(p);
+        va_start(args, format);
+        n = vsnprintf(p->tampon, TAILLE_TAMPON, format, args);
+        va_end(args);
+        if (n >= TAILLE_TAMPON) n = TAILLE_TAMPON - 1; // Ligne tronquée
     }
+    if (n > 0) p->lg += n;
+}
 
-    fclose(flot);
-    
-    flot = fopen("DATA/etudiants.don", "w");
-    if (flot == NULL) return -1; // Problème ouverture fichier
+/**
+ * \brief Réserve une ligne dans la page, en demandant la suite si la page est pleine.
+ * 
+ * La question n'est posée que lorsqu'une ligne supplémentaire doit être affichée,
+ * donc une liste qui tient sur une page ne demande jamais rien.
+ * 
+ * \param p Page en cours.
+ * \return 1 si la ligne peut être affichée, 0 si l'utilisateur arrête l'affichage.
+ */
+int pageNouvelleLigne(Page *p) {
+    int choix;
 
-    if (*tlogEtu > 0) {
-        for (int i = 0; i < *tlogEtu; i++) {
-            fprintf(flot, "%d %d %.2f\n", tNumEtu[i], tRefStage[i], tNoteFinal[i]);
-        }
+    if (p->lignes == TAILLE_PAGE) {
+        pageAjouter(p, "-- Page suivante (1) / Arrêter (0) : ");
+        pageVider(p);
+        if (lireEntier(&choix) != 1 || choix != 1) return 0;
+        p->lignes = 0;
+    }
+    p->lignes++;
+    return 1;
+}
+
+/**
+ * \brief Demande la partie d'une liste à afficher.
+ * 
+ * \param c Curseur à remplir.
+ * \param questionTri Question posée pour l'ordre des lignes (NULL : ordre naturel seulement).
+ */
+void lireCurseur(Curseur *c, const char *questionTri) {
+    c->debut = 0;
+    c->limite = 0;
+    c->tri = 0;
+
+    printf("\nPremière ligne (0 : début): ");
+    if (lireEntier(&c->debut) != 1 || c->debut < 0) c->debut = 0;
+    printf("Nombre de lignes (0 : toutes): ");
+    if (lireEntier(&c->limite) != 1 || c->limite < 0) c->limite = 0;
+    if (questionTri != NULL) {
+        printf("%s", questionTri);
+        if (lireEntier(&c->tri) != 1 || c->tri < 0) c->tri = 0;
     }
+}
 
-    fclose(flot);
+/**
+ * \brief Donne la ligne qui suit la dernière ligne à afficher.
+ * 
+ * \param c Curseur de la liste.
+ * \param nb Nombre de lignes de la liste.
+ * \return La fin (exclue) de la partie à afficher.
+ */
+int finCurseur(Curseur *c, int nb) {
+    if (c->limite == 0 || c->limite > nb - c->debut) return nb;
+    return c->debut + c->limite;
+}
+
+/**
+ * \brief Trie des positions selon une clé entière (les égalités gardent l'ordre d'origine).
+ * 
+ * \param tPos[] Positions à trier.
+ * \param nb Nombre de positions.
+ * \param tCle[] Clé de chaque position, dans l'ordre de tPos (une note est comparée en centièmes).
+ * \param decroissant 1 pour trier par clé décroissante, 0 pour l'ordre croissant.
+ * \return 1 si les positions sont triées, -1 en cas d'erreur d'allocation.
+ */
+int ordonnerPositions(int tPos[], int nb, int tCle[], int decroissant) {
+    long long *tCles, cle;
+
+    tCles = (long long *)malloc((nb + 1) * sizeof(long long));
+    if (tCles == NULL) return -1; // Problème d'allocation
+
+    // Clé en partie haute, rang d'origine en partie basse
+    for (int k = 0; k < nb; k++) {
+        cle = tCle[k];
+        if (decroissant == 1) cle = -cle;
+        tCles[k] = cle * 4294967296LL + k;
+    }
+    qsort(tCles, nb, sizeof(long long), comparerCles);
+    for (int k = 0; k < nb; k++) tCles[k] = tPos[tCles[k] & 0xFFFFFFFF];
+    for (int k = 0; k < nb; k++) tPos[k] = (int)tCles[k];
+    free(tCles);
     return 1; // Fonction réussi
 }
 
+/**
+ * \brief Trie des positions d'offres selon l'ordre choisi (les offres sont déjà dans l'ordre des références).
+ * 
+ * \param tPos[] Positions des offres à trier.
+ * \param nb Nombre de positions.
+ * \param tri 0 : référence, 1 : département, 2 : nombre de candidatures croissant.
+ * \param o Offres de stage.
+ * \return 1 si les positions sont triées, -1 en cas d'erreur d'allocation.
+ */
+int ordonnerOffres(int tPos[], int nb, int tri, Offres *o) {
+    int *tCle, code;
+
+    if (tri != 1 && tri != 2) return 1; // Ordre des références
+    tCle = (int *)malloc((nb + 1) * sizeof(int));
+    if (tCle == NULL) return -1; // Problème d'allocation
+    for (int k = 0; k < nb; k++) tCle[k] = tri == 1 ? dptOffre(o, tPos[k]) : candidOffre(o, tPos[k]);
+    code = ordonnerPositions(tPos, nb, tCle, 0);
+    free(tCle);
+    return code;
+}
+
+/**
+ * \brief Termine une liste arrêtée par l'utilisateur en indiquant comment la reprendre.
+ * 
+ * \param p Page en cours.
+ * \param ligne Première ligne non affichée.
+ */
+void pageInterrompue(Page *p, int ligne) {
+    pageAjouter(p, "Affichage interrompu : indiquez %d comme première ligne pour reprendre.\n", ligne);
+    pageVider(p);
+}
+
 
 /**
  * \brief Affiche les informations de tous les stages présents dans les tableaux.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tlog Taille logique du tableau.
- * \param tmax Taille physique du tableau.
- * \return 1 si tout s'est bien passé.
+ * \param o Offres de stage.
+ * \return 1 si tout s'est bien passé, -1 en cas d'erreur d'allocation.
  */
-int afficherTableau(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog, int tmax) {
-    int code;
+int afficherTableau(Offres *o) {
+    Page page;
+    Curseur c;
+    int *tPos, nb = 0, i, fin;
+
+    tPos = (int *)malloc((o->tlog + 1) * sizeof(int));
+    if (tPos == NULL) return -1; // Problème d'allocation
+    for (i = 0; i < o->tlog; i++) tPos[nb++] = i;
+
+    lireCurseur(&c, "Tri (0 : référence, 1 : département, 2 : candidatures): ");
+    if (ordonnerOffres(tPos, nb, c.tri, o) == -1) {
+        free(tPos);
+        return -1;
+    }
 
-    printf("\nREF\tDPT\tPOURVU\tCANDID\tETU1\tETU2\tETU3\n");
-    for (int i=0; i < *tlog; i++) {
-        printf("%d\t%d\t%d\t%d\t%d\t%d\t%d\n", tRef[i], tDpt[i], tPourvu[i], tCandid[i], tEtu1[i], tEtu2[i], tEtu3[i]);
+    pageInit(&page);
+    pageAjouter(&page, "\nREF\tDPT\tPOURVU\tCANDID\tETU1\tETU2\tETU3\n");
+    fin = finCurseur(&c, nb);
+    for (int k = c.debut; k < fin; k++) {
+        if (pageNouvelleLigne(&page) == 0) {
+            pageInterrompue(&page, k);
+            break;
+        }
+        i = tPos[k];
+        pageAjouter(&page, "%d\t%d\t%d\t%d\t%d\t%d\t%d\n", o->tRef[i], dptOffre(o, i), pourvuOffre(o, i), candidOffre(o, i), o->tEtu1[i], o->tEtu2[i], o->tEtu3[i]);
     }
+    pageVider(&page);
+    free(tPos);
     return 1; // Fonction réussi
 }
 
 /**
  * \brief Affiche uniquement les stages qui ont été pourvus.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tlogOffre Taille logique du tableau des offres de stages.
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tRefStage[] Tableau des références de stages associés aux étudiants.
- * \param tlogEtu Taille logique du tableau d'étudiants.
- * \return 1 si tout s'est bien passé.
+ * \param s Stockage des données.
+ * \return 1 si tout s'est bien passé, -1 en cas d'erreur d'allocation.
  */
-int afficherStagesPourvus(int tRef[], int tDpt[], int tPourvu[], int *tlogOffre, int tNumEtu[], int tRefStage[], int *tlogEtu) {
+int afficherStagesPourvus(Stockage *s) {
+    Offres *o = &s->offres;
     int stagePourvu = 0;
+    int *tEtuAffecte;
 
-    printf("\nREF\tDPT\tETU\n");
+    tEtuAffecte = (int *)malloc((o->tlog + 1) * sizeof(int));
+    if (tEtuAffecte == NULL) return -1; // Problème d'allocation
 
-    for (int i = 0; i < *tlogOffre; i++) {
-        if (tPourvu[i] == 1) {
-            printf("%d\t%d", tRef[i], tDpt[i]);
+    construireAffectations(o, &s->etudiants, tEtuAffecte);
 
-            int etudiantAffecte = 0;
-            for (int j = 0; j < *tlogEtu; j++) {
-                if (tRefStage[j] == tRef[i]) {
-                    etudiantAffecte = tNumEtu[j];
-                    break;
-                }
-            }
-            printf("\t%d\n", etudiantAffecte);
+    printf("\nREF\tDPT\tETU\n");
+
+    for (int i = 0; i < o->tlog; i++) {
+        if (pourvuOffre(o, i) == 1) {
+            printf("%d\t%d\t%d\n", o->tRef[i], dptOffre(o, i), tEtuAffecte[i]);
             stagePourvu = 1;
         }
     }
+    free(tEtuAffecte);
 
     if (stagePourvu == 0) {
         printf("\nAucun stage pourvu pour le moment.\n");
@@ -227,37 +485,54 @@ int afficherStagesPourvus(int tRef[], int tDpt[], int tPourvu[], int *tlogOffre,
 /**
  * \brief Affiche uniquement les stages qui n'ont pas encore été pourvus.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tlog Taille logique du tableau.
- * \return 1 si tout s'est bien passé.
+ * \param o Offres de stage.
+ * \return 1 si tout s'est bien passé, -1 en cas d'erreur d'allocation.
  */
-int afficherStagesNonPourvus(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int *tlog) {
-    printf("\nStages non pourvus :\n");
-    printf("REF\tDPT\tNB CANDID\n");
-    for (int i = 0; i < *tlog; i++) {
-        if (tPourvu[i] == 0) {
-            printf("%d\t%d\t%d\n", tRef[i], tDpt[i], tCandid[i]);
+int afficherStagesNonPourvus(Offres *o) {
+    Page page;
+    Curseur c;
+    int *tPos, nb = 0, i, fin;
+
+    tPos = (int *)malloc((o->tlog + 1) * sizeof(int));
+    if (tPos == NULL) return -1; // Problème d'allocation
+    for (i = 0; i < o->tlog; i++) {
+        if (pourvuOffre(o, i) == 0) tPos[nb++] = i;
+    }
+
+    lireCurseur(&c, "Tri (0 : référence, 1 : département, 2 : candidatures): ");
+    if (ordonnerOffres(tPos, nb, c.tri, o) == -1) {
+        free(tPos);
+        return -1;
+    }
+
+    pageInit(&page);
+    pageAjouter(&page, "\nStages non pourvus (%d) :\n", nb);
+    pageAjouter(&page, "REF\tDPT\tNB CANDID\n");
+    fin = finCurseur(&c, nb);
+    for (int k = c.debut; k < fin; k++) {
+        if (pageNouvelleLigne(&page) == 0) {
+            pageInterrompue(&page, k);
+            break;
         }
+        i = tPos[k];
+        pageAjouter(&page, "%d\t%d\t%d\n", o->tRef[i], dptOffre(o, i), candidOffre(o, i));
     }
+    pageVider(&page);
+    free(tPos);
     return 1; // Fonction réussi
 }
 
 /**
  * \brief Affiche les étudiants qui n'ont pas encore de stage.
  * 
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tRefStage[] Tableau des références de stages associés aux étudiants.
- * \param tlogEtu Taille logique du tableau.
+ * \param e Étudiants.
  * \return 1 si tout s'est bien passé.
  */
-int afficherEtudiantsSansStage(int tNumEtu[], int tRefStage[], int *tlogEtu) {
+int afficherEtudiantsSansStage(Etudiants *e) {
     printf("\nÉtudiants sans stage :\n");
-    for (int i = 0; i < *tlogEtu; i++) {
-        if (tRefStage[i] == -1) {
-            printf("ID Étudiant: %d\n", tNumEtu[i]);
+    for (int i = 0; i < e->tlog; i++) {
+        if (e->tRefStage[i] == -1) {
+            printf("ID Étudiant: %d\n", e->tNumEtu[i]);
         }
     }
     return 1; // Fonction réussi
@@ -266,278 +541,401 @@ int afficherEtudiantsSansStage(int tNumEtu[], int tRefStage[], int *tlogEtu) {
 /**
  * \brief Affiche les détails d'un stage particulier.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tlog Taille logique du tableau.
- * \return 1 si tout s'est bien passé, -1 si le stage n'a pas été trouvé.
+ * Seuls les départements qui peuvent contenir la référence sont chargés.
+ * 
+ * \param s Stockage des données.
+ * \return 1 si tout s'est bien passé, -1 si le stage n'a pas été trouvé, -3 si les offres n'ont pas pu être chargées.
  */
-int afficherInfoStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog) {
-    int ref;
+int afficherInfoStage(Stockage *s) {
+    Offres *o = &s->offres;
+    Attentes *a = &s->attentes;
+    int ref, tAttente[10];
+    int trouve, i, nb;
     printf("\nNuméro de référence du stage à afficher: ");
-    scanf("%d", &ref);
-
-    for (int i = 0; i < *tlog; i++) {
-        if (tRef[i] == ref) {
-            printf("\nInformations du stage :\n");
-            printf("REF: %d, DPT: %d, Pourvu: %d, Candidats: %d, ETU1: %d, ETU2: %d, ETU3: %d\n", tRef[i], tDpt[i], tPourvu[i], tCandid[i], tEtu1[i], tEtu2[i], tEtu3[i]);
-            return 1; // Fonction réussi
+    lireEntier(&ref);
+    if (chargerPlageRef(s, ref, ref) != 1) return -3;
+
+    i = rechercheDichoRef(o->tRef, o->tlog, ref, &trouve);
+    if (trouve == 1) {
+        printf("\nInformations du stage :\n");
+        printf("REF: %d, DPT: %d, Pourvu: %d, Candidats: %d, ETU1: %d, ETU2: %d, ETU3: %d\n", o->tRef[i], dptOffre(o, i), pourvuOffre(o, i), candidOffre(o, i), o->tEtu1[i], o->tEtu2[i], o->tEtu3[i]);
+        nb = listeAttente(a, ref, tAttente, 10);
+        if (nb > 0) {
+            printf("Liste d'attente (%d) :", nb);
+            for (int k = 0; k < nb && k < 10; k++) printf(" %d", tAttente[k]);
+            if (nb > 10) printf(" ...");
+            printf("\n");
         }
+        return 1; // Fonction réussi
     }
     return -1; // Stage non trouver
 }
 
 /**
- * \brief Recherche et affiche un ou des stage(s) à partir d'une référence ou d'un département.
+ * \brief Recherche et affiche un ou des stage(s) à partir d'une référence, d'un département ou d'un filtre.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tlog Taille logique du tableau.
- * \return 1 si le stage a été trouvé et affiché, -1 si le stage n'existe pas.
+ * Seuls les départements utiles à la recherche sont chargés.
+ * 
+ * \param s Stockage des données.
+ * \return 1 si le stage a été trouvé et affiché, -1 si le stage n'existe pas, -2 si le filtre est invalide,
+ * -3 si les offres n'ont pas pu être chargées.
  */
-int rechercherStage(int tRef[], int tDpt[], int tCandid[], int *tlog) {
-    int choix, valeurRecherchee;
+int rechercherStage(Stockage *s) {
+    Offres *o = &s->offres;
+    int choix, valeurRecherchee, trouve, i, nb, *tPos;
+    char texte[64];
+    Filtre filtre;
+    Page page;
+
     printf("\nRecherche de stage par :\n");
     printf("\t1. Numéro de référence\n");
     printf("\t2. Département\n");
+    printf("\t3. Critères combinés (ex: dpt=15,63 pourvu=0 candid<2 ref=2000-3000)\n");
     printf("Votre choix: ");
-    scanf("%d", &choix);
+    lireEntier(&choix);
 
     if (choix == 1) {
         printf("Numéro de référence: ");
-        scanf("%d", &valeurRecherchee);
-        for (int i = 0; i < *tlog; i++) {
-            if (tRef[i] == valeurRecherchee) {
-                printf("Stage trouvé : REF: %d, DPT: %d, NB CANDID: %d\n", tRef[i], tDpt[i], tCandid[i]);
-                return 1; // Fonction réussi
-            }
+        lireEntier(&valeurRecherchee);
+        if (chargerPlageRef(s, valeurRecherchee, valeurRecherchee) != 1) return -3;
+        i = rechercheDichoRef(o->tRef, o->tlog, valeurRecherchee, &trouve);
+        if (trouve == 1) {
+            printf("Stage trouvé : REF: %d, DPT: %d, NB CANDID: %d\n", o->tRef[i], dptOffre(o, i), candidOffre(o, i));
+            return 1; // Fonction réussi
         }
     } else if (choix == 2) {
         printf("Département: ");
-        scanf("%d", &valeurRecherchee);
-        for (int i = 0; i < *tlog; i++) {
-            if (tDpt[i] == valeurRecherchee) {
-                printf("Stage trouvé : REF: %d, DPT: %d, NB CANDID: %d\n", tRef[i], tDpt[i], tCandid[i]);
-            }
+        lireEntier(&valeurRecherchee);
+        if (chargerDepartement(s, valeurRecherchee) != 1) return -3;
+        tPos = (int *)malloc((o->tlog + 1) * sizeof(int));
+        if (tPos == NULL) return -1; // Problème d'allocation
+        nb = offresDuDepartement(o, valeurRecherchee, tPos);
+        for (int j = 0; j < nb; j++) {
+            i = tPos[j];
+            printf("Stage trouvé : REF: %d, DPT: %d, NB CANDID: %d\n", o->tRef[i], dptOffre(o, i), candidOffre(o, i));
         }
+        free(tPos);
+        return 1; // Fonction réussi
+    } else if (choix == 3) {
+        printf("Filtre: ");
+        lireTexte(texte);
+        if (compilerFiltre(texte, &filtre) == -1) return -2;
+        if (chargerToutesOffres(s) != 1) return -3;
+
+        tPos = (int *)malloc((o->tlog + 1) * sizeof(int));
+        if (tPos == NULL) return -1; // Problème d'allocation
+        nb = filtrerOffres(o, &filtre, tPos);
+        if (nb == 0) {
+            free(tPos);
+            return -1;
+        }
+
+        pageInit(&page);
+        pageAjouter(&page, "\n%d stage(s) trouvé(s)\nREF\tDPT\tPOURVU\tCANDID\n", nb);
+        for (int j = 0; j < nb; j++) {
+            i = tPos[j];
+            if (pageNouvelleLigne(&page) == 0) break; // Arrêt demandé
+            pageAjouter(&page, "%d\t%d\t%d\t%d\n", o->tRef[i], dptOffre(o, i), pourvuOffre(o, i), candidOffre(o, i));
+        }
+        pageVider(&page);
+        free(tPos);
         return 1; // Fonction réussi
     }
     return -1; // Aucun stage trouvé
 }
 
+/**
+ * \brief Affiche les stages dont la référence est comprise dans une plage donnée.
+ * 
+ * Seuls les départements dont les références rencontrent la plage sont chargés.
+ * 
+ * \param s Stockage des données.
+ * \return 1 si au moins un stage a été affiché, -1 si aucun stage n'est dans la plage, -3 si les offres n'ont pas pu être chargées.
+ */
+int afficherPlageRef(Stockage *s) {
+    Offres *o = &s->offres;
+    int refMin, refMax, trouve, i;
+    printf("\nRéférence minimale: ");
+    lireEntier(&refMin);
+    printf("Référence maximale: ");
+    lireEntier(&refMax);
+    if (chargerPlageRef(s, refMin, refMax) != 1) return -3;
+
+    i = rechercheDichoRef(o->tRef, o->tlog, refMin, &trouve);
+    if (i >= o->tlog || o->tRef[i] > refMax) return -1; // Aucun stage dans la plage
+
+    Page page;
+    pageInit(&page);
+
+    pageAjouter(&page, "\nREF\tDPT\tPOURVU\tCANDID\n");
+    while (i < o->tlog && o->tRef[i] <= refMax) {
+        if (pageNouvelleLigne(&page) == 0) {
+            printf("Affichage interrompu à la référence %d.\n", o->tRef[i]);
+            return 1;
+        }
+        pageAjouter(&page, "%d\t%d\t%d\t%d\n", o->tRef[i], dptOffre(o, i), pourvuOffre(o, i), candidOffre(o, i));
+        i++;
+    }
+    pageVider(&page);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Affiche les références voisines d'une référence donnée ainsi que la prochaine référence libre.
+ * 
+ * \param o Offres de stage (triées par référence croissante).
+ * \return 1 si tout s'est bien passé.
+ */
+int afficherVoisinsRef(Offres *o) {
+    int ref, prec, suiv;
+    printf("\nNuméro de référence: ");
+    lireEntier(&ref);
+
+    prec = predecesseurRef(o->tRef, o->tlog, ref);
+    suiv = successeurRef(o->tRef, o->tlog, ref);
+
+    if (prec == -1) printf("Référence précédente: aucune\n");
+    else printf("Référence précédente: %d\n", prec);
+    if (suiv == -1) printf("Référence suivante: aucune\n");
+    else printf("Référence suivante: %d\n", suiv);
+    printf("Prochaine référence libre: %d\n", prochaineRefLibre(o->tRef, o->tlog, ref));
+    return 1; // Fonction réussi
+}
+
 /**
  * \brief Ajoute une nouvelle offre de stage dans les tableaux.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tlog Taille logique du tableau.
- * \param tmax Taille physique du tableau.
- * \return 1 si le stage a été ajouté avec succès, -1 ou -2 si il y a eu une erreur.
+ * \param s Stockage des données.
+ * \return 1 si le stage a été ajouté avec succès, -1, -2 ou -3 si il y a eu une erreur (voir ajouterOffre).
  */
-int ajoutStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog, int tmax) {
+int ajoutStage(Stockage *s) {
     int ref, dept;
     
     printf("\nNuméro de référence du stage: ");
-    scanf("%d", &ref);
+    lireEntier(&ref);
     printf("Département du stage: ");
-    scanf("%d", &dept);
+    lireEntier(&dept);
+
+    return ajouterOffre(s, ref, dept);
+}
+
+/**
+ * \brief Supprime une offre de stage du tableau.
+ * 
+ * \param s Stockage des données.
+ * \return 1 si le stage a été supprimé avec succès, -1 si le stage n'a pas été trouvé.
+ */
+int supprimerStage(Stockage *s) {
+    int ref;
+    printf("\nNuméro de référence du stage à supprimer: ");
+    lireEntier(&ref);
+
+    return supprimerOffre(s, ref);
+}
 
-    for (int i = 0; i < *tlog; i++) {
-        if (tRef[i] == ref) return -1; // Stage existe déjà
+/**
+ * \brief Affiche les stages disponibles
+ * 
+ * \param o Offres de stage.
+ */
+void StagesDispo(Offres *o) {
+    for (int i = 0; i < o->tlog; i++) {
+        if (pourvuOffre(o, i) == 0 && candidOffre(o, i) >= 1) {
+            printf("Référence: %d, Département: %d, Nombre de candidature: %d\n", o->tRef[i], dptOffre(o, i), candidOffre(o, i));
+        }
     }
-    
-    if (*tlog < tmax) {
-        tRef[*tlog] = ref;
-        tDpt[*tlog] = dept;
-        tPourvu[*tlog] = 0;
-        tCandid[*tlog] = 0;
-        tEtu1[*tlog] = 0;
-        tEtu2[*tlog] = 0;
-        tEtu3[*tlog] = 0;
-        (*tlog)++;
-        return 1; // Fonction réussi
+}
+
+/**
+ * \brief Affiche les candidats d'un stage classés par note décroissante.
+ * 
+ * Les candidats sont lus directement dans les emplacements ETU1 à ETU3 du stage,
+ * sans parcourir les autres offres.
+ * 
+ * \param s Stockage des données.
+ * \param pos Position du stage dans les tableaux des offres.
+ * \return Le nombre de candidats affichés.
+ */
+int afficherCandidatsClasses(Stockage *s, int pos) {
+    Offres *o = &s->offres;
+    Etudiants *e = &s->etudiants;
+    int tCandidats[3] = {o->tEtu1[pos], o->tEtu2[pos], o->tEtu3[pos]};
+    int tPlace[3], nb = 0, place, j;
+
+    for (int i = 0; i < 3; i++) {
+        if (tCandidats[i] == 0) continue; // Emplacement vide
+        place = rechercherEtudiant(e->tNumEtu, e->tlog, tCandidats[i]);
+        if (place == -1) continue; // Étudiant inconnu
+
+        j = nb;
+        while (j > 0 && noteEtudiant(e, tPlace[j - 1]) < noteEtudiant(e, place)) {
+            tPlace[j] = tPlace[j - 1];
+            j--;
+        }
+        tPlace[j] = place;
+        nb++;
     }
-    else {
-        return -2; // Tableau trop petit
+
+    for (int i = 0; i < nb; i++) {
+        if (noteEtudiant(e, tPlace[i]) < 0) printf("ID Étudiant: %d, Note: -\n", e->tNumEtu[tPlace[i]]);
+        else printf("ID Étudiant: %d, Note: %.2f\n", e->tNumEtu[tPlace[i]], noteEtudiant(e, tPlace[i]));
     }
+    return nb;
 }
 
 /**
- * \brief Décalle à gauche tout les tableaux des stages.
+ * \brief Affiche les k meilleurs étudiants qui n'ont pas encore de stage.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tlog Taille logique du tableau.
- * \param ref Numéro de référence du stage à décaler.
- * \return 1 si le stage a été supprimé avec succès, -1 si le stage n'a pas été trouvé.
+ * \param e Étudiants.
+ * \return 1 si tout s'est bien passé, -1 si k est invalide, -2 en cas d'erreur d'allocation.
  */
-int decalerAgauche(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog, int ref) {
-    for (int i = 0; i < *tlog; i++) {
-        if (tRef[i] == ref) {
-            for (int j = i; j < *tlog - 1; j++) {
-                tRef[j] = tRef[j + 1];
-                tDpt[j] = tDpt[j + 1];
-                tPourvu[j] = tPourvu[j + 1];
-                tCandid[j] = tCandid[j + 1];
-                tEtu1[j] = tEtu1[j + 1];
-                tEtu2[j] = tEtu2[j + 1];
-                tEtu3[j] = tEtu3[j + 1];
-            }
-            (*tlog)--;
-            printf("Stage supprimé avec succès!\n");
-            return 1; // Fonction réussi
-        }
+int afficherMeilleursSansStage(Etudiants *e) {
+    int k, nb, *tMeilleurs;
+    printf("\nNombre d'étudiants à afficher: ");
+    lireEntier(&k);
+    if (k <= 0) return -1;
+    if (k > e->tlog) k = e->tlog;
+
+    tMeilleurs = (int *)malloc((k + 1) * sizeof(int));
+    if (tMeilleurs == NULL) return -2; // Problème d'allocation
+
+    // Tas reconstruit à chaque affichage : rien n'est maintenu entre deux appels
+    nb = meilleursSansStage(e, k, tMeilleurs);
+    printf("\nRANG\tNUM\tNOTE\n");
+    for (int i = 0; i < nb; i++) {
+        if (noteEtudiant(e, tMeilleurs[i]) < 0) printf("%d\t%d\t-\n", i + 1, e->tNumEtu[tMeilleurs[i]]);
+        else printf("%d\t%d\t%.2f\n", i + 1, e->tNumEtu[tMeilleurs[i]], noteEtudiant(e, tMeilleurs[i]));
     }
-    return -1; // Problème
+    free(tMeilleurs);
+    return 1; // Fonction réussi
 }
 
 /**
- * \brief Supprime une offre de stage du tableau.
+ * \brief Affiche les offres dont au moins un candidat n'a pas encore de stage.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tlog Taille logique du tableau.
- * \return 1 si le stage a été supprimé avec succès, -1 si le stage n'a pas été trouvé.
+ * \param s Stockage des données.
+ * \return Le nombre d'offres affichées, -1 si aucune, -2 en cas d'erreur d'allocation.
  */
-int supprimerStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog) {
-    int ref, dept, code;
-    printf("\nNuméro de référence du stage à supprimer: ");
-    scanf("%d", &ref);
+int afficherOffresCandidatSansStage(Stockage *s) {
+    Offres *o = &s->offres;
+    MatriceCandidats m;
+    int *tOffres, *tNb, nb;
+
+    tOffres = (int *)malloc((o->tlog + 1) * sizeof(int));
+    tNb = (int *)malloc((o->tlog + 1) * sizeof(int));
+    if (tOffres == NULL || tNb == NULL || construireMatrice(&m, o, &s->etudiants) == -1) {
+        free(tOffres);
+        free(tNb);
+        return -2; // Problème d'allocation
+    }
 
-    code = decalerAgauche(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tlog, ref);
-    if (code == 1) return 1; // Aucun problème
-    else return -1; // Stage non trouvé
+    nb = offresCandidatSansStage(&m, s->etudiants.tRefStage, tOffres, tNb);
+    if (nb > 0) {
+        printf("\nREF\tDPT\tCANDIDATS\tSANS STAGE\n");
+        for (int i = 0; i < nb; i++) {
+            printf("%d\t%d\t%d\t\t%d\n", o->tRef[tOffres[i]], dptOffre(o, tOffres[i]), nbCandidatsLigne(&m, tOffres[i]), tNb[i]);
+        }
+    }
+    libererMatrice(&m);
+    free(tOffres);
+    free(tNb);
+    if (nb == 0) return -1;
+    return nb;
 }
 
 /**
- * \brief Affiche les stages disponibles
+ * \brief Compare les politiques d'affectation sur de nombreux tours simulés, sans modifier les données.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tlog Taille logique du tableau des offres de stages.
+ * \param s Stockage des données.
+ * \return 1 si la simulation s'est bien passée, -1 si le nombre de tours est invalide, -2 en cas d'erreur d'allocation.
  */
-void StagesDispo(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int *tlog) {
-    for (int i = 0; i < *tlog; i++) {
-        if (tPourvu[i] == 0 && tCandid[i] >= 1) {
-            printf("Référence: %d, Département: %d, Nombre de candidature: %d\n", tRef[i], tDpt[i], tCandid[i]);
+int simulerPolitiques(Stockage *s) {
+    char *tNoms[NB_POLITIQUES] = {"Note", "Ordre", "Hasard"};
+    int nbTours, *tPourvus, *tSansStage, *tHisto, code = 1;
+    int minP, maxP, minS, maxS, plusGrand;
+    unsigned int graine = (unsigned int)time(NULL); // Mêmes tirages pour toutes les politiques
+    double moyP, moyS, debut;
+    Instantane *inst;
+
+    printf("\nNombre de tours à simuler: ");
+    lireEntier(&nbTours);
+    if (nbTours <= 0) return -1;
+
+    inst = creerInstantane(s); // Copie privée : l'état non validé n'est pas publié
+    if (inst == NULL) return -2;
+
+    tPourvus = (int *)malloc(nbTours * sizeof(int));
+    tSansStage = (int *)malloc(nbTours * sizeof(int));
+    tHisto = (int *)malloc((inst->etudiants.tlog + 1) * sizeof(int));
+    if (tPourvus == NULL || tSansStage == NULL || tHisto == NULL) code = -2;
+
+    for (int p = 0; p < NB_POLITIQUES && code == 1; p++) {
+        debut = maintenant();
+        if (simulerAffectations(inst, p, nbTours, graine, tPourvus, tSansStage) == -1) {
+            code = -2;
+            break;
+        }
+        resumerSerie(tPourvus, nbTours, &minP, &maxP, &moyP);
+        resumerSerie(tSansStage, nbTours, &minS, &maxS, &moyS);
+
+        printf("\nPolitique %s (%d tours, %.0f ms)\n", tNoms[p], nbTours, maintenant() - debut);
+        printf("\tStages pourvus : min %d, moyenne %.2f, max %d sur %d (%.1f %%)\n", minP, moyP, maxP, inst->offres.tlog, inst->offres.tlog > 0 ? 100 * moyP / inst->offres.tlog : 0);
+        printf("\tÉtudiants sans stage : min %d, moyenne %.2f, max %d\n", minS, moyS, maxS);
+
+        // Répartition des étudiants sans stage
+        plusGrand = 0;
+        for (int v = minS; v <= maxS; v++) tHisto[v] = 0;
+        for (int t = 0; t < nbTours; t++) tHisto[tSansStage[t]]++;
+        for (int v = minS; v <= maxS; v++) {
+            if (tHisto[v] > plusGrand) plusGrand = tHisto[v];
+        }
+        for (int v = minS; v <= maxS; v++) {
+            printf("\t%4d sans stage | ", v);
+            for (int b = 0; b < 40 * tHisto[v] / plusGrand; b++) printf("#");
+            printf(" %d\n", tHisto[v]);
         }
     }
+
+    libererInstantane(inst);
+    free(tPourvus);
+    free(tSansStage);
+    free(tHisto);
+    return code;
 }
 
 /**
  * \brief Affecte un étudiant à un stage spécifique.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tlog Taille logique du tableau des offres de stages.
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tRefStage[] Tableau des références de stages associés aux étudiants.
- * \param tNoteFinal[] Tableau des moyennes finales des étudiants.
- * \param tlogEtu Taille logique du tableau d'étudiants.
- * \return 1 si l'affectation a réussi, -1 si pas candidat, -2 si le stage existe pas.
+ * \param s Stockage des données.
+ * \return 1 si l'affectation a réussi, -1 si pas candidat, -2 si le stage existe pas, -3 en cas de retour,
+ * -4 si les offres n'ont pas pu être chargées.
  */
-int affecterEtudiant(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog, int tNumEtu[], int tRefStage[], float tNoteFinal[], int *tlogEtu) {
-    int ref, place, x;
+int affecterEtudiant(Stockage *s) {
+    Offres *o = &s->offres;
+    int ref;
 
+    if (chargerToutesOffres(s) != 1) return -4; // Tous les stages sont listés
     printf("\nStages disponibles :\n");
-    StagesDispo(tRef, tDpt, tPourvu, tCandid, tlog);
+    StagesDispo(o);
 
     printf("\nNuméro de référence du stage: ");
-    scanf("%d", &ref);
+    lireEntier(&ref);
 
-    int stageTrouve = -1;
-    for (int i = 0; i < *tlog; i++) {
-        if (tRef[i] == ref) {
-            stageTrouve = i;
-            break;
-        }
-    }
+    int trouve;
+    int stageTrouve = rechercheDichoRef(o->tRef, o->tlog, ref, &trouve);
 
-    if (stageTrouve == -1) return -2; // Stage non trouver
+    if (trouve == 0) return -2; // Stage non trouver
 
     printf("\nÉtudiants candidats pour ce stage :\n");
-    for (int i = 0; i < *tlog; i++) {
-        if (tRef[i] == ref) {
-            for (x = 0; x < *tlogEtu; x++) {
-                if (tEtu1[i] == tNumEtu[x] || tEtu2[i] == tNumEtu[x] || tEtu3[i] == tNumEtu[x]) {
-                    printf("ID Étudiant: %d, Note: %d\n", tNumEtu[x], tNoteFinal[x]);
-                    place = x;
-                }
-            }
-        }
-    }
+    afficherCandidatsClasses(s, stageTrouve);
 
     int etu;
     printf("ID de l'étudiant à affecter (ou 0 pour revenir en arrière): ");
-    scanf("%d", &etu);
+    lireEntier(&etu);
 
     if (etu == 0) return -3;
 
-    for (int i = 0; i < *tlog; i++) {
-        if (tRefStage[i] != ref) {
-            if (tEtu1[i] == etu) {
-                tEtu1[i] = tEtu2[i];
-                tEtu2[i] = tEtu3[i];
-                tEtu3[i] = 0;
-                tCandid[i]--;
-            }
-            else if (tEtu2[i] == etu) {
-                tEtu2[i] = tEtu3[i];
-                tEtu3[i] = 0;
-                tCandid[i]--;
-            }
-            else if (tEtu3[i] == etu) {
-                tEtu3[i] = 0;
-                tCandid[i]--;
-            }
-        }
-    }
-
-    for (int j = 0; j < *tlogEtu; j++) {
-        if (tNumEtu[j] == etu) {
-            tRefStage[j] = ref; 
-            break;
-        }
-    }
-
-    for (int i = 0; i < *tlog; i++) {
-        if (tRef[i] == ref) {
-            tPourvu[i] = 1;
-            tCandid[i] = 0;
-            tEtu1[i] = 0;
-            tEtu2[i] = 0;
-            tEtu3[i] = 0;
-            return 1; // Fonction réussi
-        }
-    }
-    return -1; // L'étudiant n'est pas candidat pour ce stage
+    return affecterOffre(s, ref, etu);
 }
 
 /**
@@ -558,91 +956,156 @@ int menuResponsable(void) {
     printf("\t7. Afficher les étudiants sans stage\n");
     printf("\t8. Rechercher un stage (par numéro ou département)\n");
     printf("\t9. Afficher les informations d'un stage donné\n");
-    printf("\t10. Quitter\n");
+    printf("\t10. Afficher les stages d'une plage de références\n");
+    printf("\t11. Afficher les références voisines et la prochaine référence libre\n");
+    printf("\t12. Afficher les meilleurs étudiants sans stage\n");
+    printf("\t13. Afficher les stages ayant un candidat sans stage\n");
+    printf("\t14. Simuler les politiques d'affectation\n");
+    printf("\t15. Annuler les modifications de la session\n");
+    printf("\t16. Quitter\n");
     printf("Votre choix: ");
-    scanf("%d", &choix);
+    lireEntier(&choix);
     return choix;
 }
 
 /**
  * \brief Gère les actions du responsable de stage.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tRefStage[] Tableau des références de stages associés aux étudiants.
- * \param tNoteFinal[] Tableau des moyennes finales des étudiants.
- * \param tlogOffre Taille logique du tableau des offres de stages.
- * \param tmaxOffre Taille physique du tableau des offres de stages.
- * \param tlogEtu Taille logique du tableau d'étudiants.
- * \param tmaxEtu Taille physique du tableau d'étudiants.
+ * \param s Stockage des données.
  * \return 1 si toutes les actions ont été effectuées avec succès, -1 si une erreur est survenue.
  */
-int globalResponsable(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int tNumEtu[], int tRefStage[], float tNoteFinal[], int *tlogOffre, int tmaxOffre, int *tlogEtu, int tmaxEtu) {
+int globalResponsable(Stockage *s) {
     int choix, code;
+    debutTransaction();
     choix = menuResponsable();
-    while (choix != 10) {
+    while (choix != 16) {
         switch (choix) {
         // Action :
             case 1: // Ajouter une offre de stage
-                code = ajoutStage(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tlogOffre, tmaxOffre);
+                code = ajoutStage(s);
                 if (code == 1) printf("\nLe stage a été ajouté avec succès !\n");
                 if (code == -1) printf("\nLe stage avec ce numéro de référence et ce département existe déjà !\n");
-                if (code == -2) printf("\nLe tableau est trop petit !\n");
+                if (code == -2) printf("\nLe tableau est trop petit ou les offres n'ont pas pu être chargées !\n");
+                if (code == -3) printf("\nLe numéro de département doit être compris entre %d et %d !\n", DPT_MIN, DPT_MAX);
                 break;
 
             case 2: // Supprimer une offre de stage
-                code = supprimerStage(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tlogOffre);
+                code = supprimerStage(s);
                 if (code == 1) printf("\nLe stage a été supprimé avec succès !\n");
                 if (code == -1) printf("\nAucun stage trouvé avec ce numéro de référence !\n");
+                if (code == -2) printf("\nImpossible de charger les offres !\n");
                 break;
 
             case 3: // Affecter un stage à un étudiant
-                code = affecterEtudiant(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tlogOffre, tNumEtu, tRefStage, tNoteFinal, tlogEtu);
+                code = affecterEtudiant(s);
                 if (code == 1) printf("\nL'étudiant a été affecté avec succès !\n");
                 if (code == -1) printf("\nL'étudiant n'est pas candidat pour ce stage.\n");
                 if (code == -2) printf("\nStage non trouvé.\n");
+                if (code == -4) printf("\nImpossible de charger les offres !\n");
                 break;
 
         // Affichage :
             case 4: // Afficher tous les stages
-                code = afficherTableau(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tlogOffre, tmaxOffre);
+                if (chargerToutesOffres(s) != 1) {
+                    printf("\nImpossible de charger les offres !\n");
+                    break;
+                }
+                code = afficherTableau(&s->offres);
+                if (code == -1) printf("\nMémoire insuffisante !\n");
                 break;
 
             case 5: // Afficher les stages pourvus avec étudiants affectés
-                code = afficherStagesPourvus(tRef, tDpt, tPourvu, tlogOffre, tNumEtu, tRefStage, tlogEtu);
+                if (chargerToutesOffres(s) != 1) {
+                    printf("\nImpossible de charger les offres !\n");
+                    break;
+                }
+                code = afficherStagesPourvus(s);
+                if (code == -1) printf("\nMémoire insuffisante pour afficher les stages pourvus !\n");
                 break;
 
             case 6: // Afficher les stages non pourvus
-                code = afficherStagesNonPourvus(tRef, tDpt, tPourvu, tCandid, tlogOffre);
+                if (chargerToutesOffres(s) != 1) {
+                    printf("\nImpossible de charger les offres !\n");
+                    break;
+                }
+                code = afficherStagesNonPourvus(&s->offres);
+                if (code == -1) printf("\nMémoire insuffisante !\n");
                 break;
 
             case 7: // Afficher les étudiants sans stage
-                code = afficherEtudiantsSansStage(tNumEtu, tRefStage, tlogEtu);
+                code = afficherEtudiantsSansStage(&s->etudiants);
                 break;
 
             case 8: // Rechercher un stage par numéro ou département
-                code = rechercherStage(tRef, tDpt, tCandid, tlogOffre);
+                code = rechercherStage(s);
                 if (code == -1) printf("\nStage non trouvé !\n");
+                if (code == -2) printf("\nFiltre invalide !\n");
+                if (code == -3) printf("\nImpossible de charger les offres !\n");
                 break;
 
             case 9: // Afficher les informations d'un stage donné
-                code = afficherInfoStage(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tlogOffre);
+                code = afficherInfoStage(s);
                 if (code == -1) printf("\nStage non trouvé !\n");
+                if (code == -3) printf("\nImpossible de charger les offres !\n");
+                break;
+
+            case 10: // Afficher les stages d'une plage de références
+                code = afficherPlageRef(s);
+                if (code == -1) printf("\nAucun stage dans cette plage de références !\n");
+                if (code == -3) printf("\nImpossible de charger les offres !\n");
+                break;
+
+            case 11: // Afficher les références voisines
+                if (chargerToutesOffres(s) != 1) {
+                    printf("\nImpossible de charger les offres !\n");
+                    break;
+                }
+                code = afficherVoisinsRef(&s->offres);
+                break;
+
+            case 12: // Afficher les meilleurs étudiants sans stage
+                code = afficherMeilleursSansStage(&s->etudiants);
+                if (code == -1) printf("\nNombre d'étudiants invalide !\n");
+                if (code == -2) printf("\nMémoire insuffisante !\n");
+                break;
+
+            case 13: // Afficher les stages ayant un candidat sans stage
+                if (chargerToutesOffres(s) != 1) {
+                    printf("\nImpossible de charger les offres !\n");
+                    break;
+                }
+                code = afficherOffresCandidatSansStage(s);
+                if (code == -1) printf("\nAucun stage n'a de candidat sans stage !\n");
+                if (code == -2) printf("\nMémoire insuffisante !\n");
+                break;
+
+            case 14: // Simuler les politiques d'affectation
+                if (chargerToutesOffres(s) != 1) {
+                    printf("\nImpossible de charger les offres !\n");
+                    break;
+                }
+                code = simulerPolitiques(s);
+                if (code == -1) printf("\nNombre de tours invalide !\n");
+                if (code == -2) printf("\nMémoire insuffisante !\n");
+                break;
+
+            case 15: // Annuler les modifications de la session
+                code = annulerTransaction(s);
+                if (code >= 0) printf("\n%d modification(s) annulée(s).\n", code);
+                if (code == -2) printf("\nLe journal est incomplet, annulation impossible !\n");
                 break;
 
             default: // Choix invalide
                 printf("\nChoix non valide !\n");
                 break;
         }
+        signalerEchecsSauvegarde();
         choix = menuResponsable();
     }
-    code = modificationFichier(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tlogOffre, tNumEtu, tRefStage, tNoteFinal, tlogEtu);
+    validerTransaction();
+    code = publierInstantane(s);
+    if (code == -1) code = modificationFichier(s);
+    else code = demanderSauvegarde();
     if (code == 1) return 1; // Fonction réussi
     else return -1; // Problème ouverture fichier
 }
@@ -651,48 +1114,58 @@ int globalResponsable(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int
 /**
  * \brief Affiche la liste des stages disponibles.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tlogOffre Taille logique du tableau des offres de stages
- * \return 1 si l'affichage s'est bien déroulé.
+ * \param o Offres de stage.
+ * \return 1 si l'affichage s'est bien déroulé, -1 si aucun stage n'est disponible, -2 en cas d'erreur d'allocation.
  */
-int listeStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int *tlogOffre) {
-    printf("\nListe des stages disponibles :\n");
-    int stageTrouve = 0;
-
-    for (int i = 0; i < *tlogOffre; i++) {
-        if (tPourvu[i] == 0 && tCandid[i] < 3) {
-            printf("Référence: %d, Département: %d, Nombre de candidatures: %d\n", tRef[i], tDpt[i], tCandid[i]);
-            stageTrouve = 1;
+int listeStage(Offres *o) {
+    Page page;
+    Curseur c;
+    int *tPos, nb = 0, i, fin;
+
+    tPos = (int *)malloc((o->tlog + 1) * sizeof(int));
+    if (tPos == NULL) return -2; // Problème d'allocation
+    for (i = 0; i < o->tlog; i++) {
+        if (pourvuOffre(o, i) == 0 && candidOffre(o, i) < 3) tPos[nb++] = i;
+    }
+    if (nb == 0) {
+        free(tPos);
+        return -1;
+    }
+
+    lireCurseur(&c, "Tri (0 : référence, 1 : département, 2 : candidatures): ");
+    if (ordonnerOffres(tPos, nb, c.tri, o) == -1) {
+        free(tPos);
+        return -2;
+    }
+
+    pageInit(&page);
+    pageAjouter(&page, "\nListe des stages disponibles (%d) :\n", nb);
+    fin = finCurseur(&c, nb);
+    for (int k = c.debut; k < fin; k++) {
+        if (pageNouvelleLigne(&page) == 0) {
+            pageInterrompue(&page, k);
+            break;
         }
+        i = tPos[k];
+        pageAjouter(&page, "Référence: %d, Département: %d, Nombre de candidatures: %d\n", o->tRef[i], dptOffre(o, i), candidOffre(o, i));
     }
-    if (stageTrouve == 0) return -1;
+    pageVider(&page);
+    free(tPos);
     return 1; // Fonction réussi 
 }
 
 /**
  * \brief Permet à un étudiant de candidater à un stage.
  *
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tlogOffre Taille logique du tableau des offres de stages
- * \param tlogEtu Taille logique du tableau d'étudiants.
- * \param tNumEtu[] Tableau des numéros des étudiants.
+ * \param s Stockage des données.
  * \param etudiantID ID de l'étudiant qui candidate.
  */
-int candidaterStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlogOffre, int *tlogEtu, int tNumEtu[], int etudiantID) {
-    int refStage, foundStage = 0;
+int candidaterStage(Stockage *s, int etudiantID) {
+    int refStage;
     int nbCandidatures = 0;
 
-    for (int i = 0; i < *tlogEtu; i++) {
-        if (tNumEtu[i] == etudiantID) {
+    for (int i = 0; i < s->etudiants.tlog; i++) {
+        if (s->etudiants.tNumEtu[i] == etudiantID) {
             nbCandidatures++;
         }
     }
@@ -700,101 +1173,59 @@ int candidaterStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tE
     if (nbCandidatures >= 3) return -1;
 
     printf("\nEntrez la référence du stage pour candidater (0: Annuler): ");
-    scanf("%d", &refStage);
+    lireEntier(&refStage);
 
     if (refStage == 0) return -2;
 
-    for (int i = 0; i < *tlogOffre; i++) {
-        if (tRef[i] == refStage) {
-            if (tPourvu[i] == 1) return -3;
-            if (tEtu1[i] == etudiantID || tEtu2[i] == etudiantID || tEtu3[i] == etudiantID) return -4;
-
-            if (tCandid[i] < 3) {
-                if (tEtu1[i] == 0) {
-                    tEtu1[i] = etudiantID;
-                } else if (tEtu2[i] == 0) {
-                    tEtu2[i] = etudiantID;
-                } else if (tEtu3[i] == 0) {
-                    tEtu3[i] = etudiantID;
-                }
-                tCandid[i]++;
-
-                return 1; // Fonction réussi
-            } 
-            else return -5;
-        }
-    }
-    return -6;
+    return candidaterOffre(s, refStage, etudiantID);
 }
 
 /**
  * \brief Permet de voir les candidatures d'un étudiant.
  * 
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tRefStage[] Tableau des références de stages associés aux étudiants.
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tlogEtu Taille logique du tableau d'étudiants.
- * \param tlogOffre Taille logique du tableau des offres de stages.
+ * \param s Stockage des données.
  * \param etudiantID Identifiant de l'étudiant concerné.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \return 0 si la consultation s'est bien déroulée, -1 en cas d'erreur.
+ * \return 1 si la consultation s'est bien déroulée, -1 si l'étudiant n'existe pas, -2 si son stage n'a pas été trouvé.
  */
-int voirCandidature(int tNumEtu[], int tRefStage[], int tRef[], int tDpt[], int tPourvu[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlogEtu, int *tlogOffre, int etudiantID, int tCandid[]) {
-    int indexEtu = -1;
-    for (int i = 0; i < *tlogEtu; i++) {
-        if (tNumEtu[i] == etudiantID) {
-            indexEtu = i;
-            break;
-        }
-    }
+int voirCandidature(Stockage *s, int etudiantID) {
+    Offres *o = &s->offres;
+    int indexEtu = rechercherEtudiant(s->etudiants.tNumEtu, s->etudiants.tlog, etudiantID);
     
     if (indexEtu == -1) return -1; // Étudiant non trouvé
 
-    int refStage = tRefStage[indexEtu];
+    int refStage = s->etudiants.tRefStage[indexEtu];
 
     if (refStage == -1) {
         printf("\nMes candidatures :\n");
         printf("REF\tDPT\tNB CANDID\n");
-        for (int i = 0; i < *tlogOffre; i++) {
-            if (tEtu1[i] == etudiantID || tEtu2[i] == etudiantID || tEtu3[i] == etudiantID) {
-                printf("%d\t%d\t%d\n", tRef[i], tDpt[i], tCandid[i]);
+        for (int i = 0; i < o->tlog; i++) {
+            if (o->tEtu1[i] == etudiantID || o->tEtu2[i] == etudiantID || o->tEtu3[i] == etudiantID) {
+                printf("%d\t%d\t%d\n", o->tRef[i], dptOffre(o, i), candidOffre(o, i));
             }
         }
         return 1; // Fonction réussi
     } else {
-        for (int j = 0; j < *tlogOffre; j++) {
-            if (tRef[j] == refStage) {
-                printf("\nVous avez été affecter à un stage :\n");
-                printf("Référence: %d, Département: %d\n", tRef[j], tDpt[j]);
-                return 1; // Fonction réussi
-            }
+        int trouve;
+        int j = rechercheDichoRef(o->tRef, o->tlog, refStage, &trouve);
+        if (trouve == 1) {
+            printf("\nVous avez été affecter à un stage :\n");
+            printf("Référence: %d, Département: %d\n", o->tRef[j], dptOffre(o, j));
+            return 1; // Fonction réussi
         }
         return -2; // Aucun stage trouvé
     }
-
-    return 1; // Fonction réussie
 }
 
 /**
  * \brief Vérifie si l'étudiant existe à partir de son identifiant.
  * 
  * \param id Identifiant de l'étudiant.
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tlogEtu Taille logique du tableau.
+ * \param e Étudiants.
  * \return 1 si l'étudiant est trouvé, -1 sinon.
  */
-int verifieLogin(int id, int tNumEtu[], int tlogEtu) {
-    for (int i = 0; i < tlogEtu; i++) {
-        if (tNumEtu[i] == id) {
-            return 1; // Fonction réussi
-        }
-    }
-    return -1;
+int verifieLogin(int id, Etudiants *e) {
+    if (rechercherEtudiant(e->tNumEtu, e->tlog, id) == -1) return -1;
+    return 1; // Fonction réussi
 }
 
 /**
@@ -805,7 +1236,7 @@ int verifieLogin(int id, int tNumEtu[], int tlogEtu) {
 int login(void) {
     int id;
     printf("\nQuel est votre identifiant : ");
-    scanf("%d", &id);
+    lireEntier(&id);
     return id;
 }
 
@@ -820,70 +1251,79 @@ int menuEtudiant(void) {
     printf("\t1. Afficher la liste de stage\n");
     printf("\t2. Candidater à un stage\n");
     printf("\t3. Voir vos candidatures\n");
-    printf("\t4. Quitter\n");
+    printf("\t4. Annuler mes modifications de la session\n");
+    printf("\t5. Quitter\n");
     printf("Votre choix: ");
-    scanf("%d", &choix);
+    lireEntier(&choix);
     return choix;
 }
 
 /**
  * \brief Gère les actions de l'étudiant.
 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tRefStage[] Tableau des références de stages associés aux étudiants.
- * \param tNoteFinal[] Tableau des moyennes finales des étudiants.
- * \param tlogOffre Taille logique du tableau des offres de stages.
- * \param tmaxOffre Taille physique du tableau des offres de stages.
- * \param tlogEtu Taille logique du tableau d'étudiants.
- * \param tmaxEtu Taille physique du tableau d'étudiants.
+ * \param s Stockage des données.
  * \return 1 si toutes les actions ont été effectuées avec succès, -1 en cas d'erreur.
  */
-int globalEtudiant(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int tNumEtu[], int tRefStage[], float tNoteFinal[], int *tlogOffre, int tmaxOffre, int *tlogEtu, int tmaxEtu) {
+int globalEtudiant(Stockage *s) {
     int choix, code, id;
     
     id = login();
-    code = verifieLogin(id, tNumEtu, *tlogEtu);
+    code = verifieLogin(id, &s->etudiants);
     if (code == 1) {
+        debutTransaction();
         choix = menuEtudiant();
-        while(choix!=4) {
+        while(choix!=5) {
             switch (choix)
             {
             case 1: // Afficher la liste de stage
-                code = listeStage(tRef, tDpt, tPourvu, tCandid, tlogOffre);
+                if (chargerToutesOffres(s) != 1) {
+                    printf("\nImpossible de charger les offres !\n");
+                    break;
+                }
+                code = listeStage(&s->offres);
                 if (code == -1) printf("\nAucun stage n'a été trouver !\n");
+                if (code == -2) printf("\nMémoire insuffisante !\n");
                 break;
             
             case 2: // Candidater à un stage
-                code = candidaterStage(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tlogOffre, tlogEtu, tNumEtu, id);
+                code = candidaterStage(s, id);
                 if (code == 1) printf("\nCandidature réussie pour le stage !\n");
+                if (code == 2) printf("\nLe stage possède déjà 3 candidats : vous avez été placé en liste d'attente.\n");
                 if (code == -1) printf("\nVous avez atteint le nombre maximum de candidatures (3).\n");
                 if (code == -2) printf("\nAucun candidature n'a été faites !\n");
                 if (code == -3) printf("\nLe stage a déjà été pourvu !\n");
-                if (code == -4) printf("\nVous êtes déjà candidat pour ce stage.\n");
-                if (code == -5) printf("\nLe stage que vous avez demandé possède déjà 3 candidats.\n");
+                if (code == -4) printf("\nVous êtes déjà candidat ou en attente pour ce stage.\n");
                 if (code == -6) printf("\nStage non trouvé.\n");
+                if (code == -7) printf("\nMémoire insuffisante ou offres impossibles à charger !\n");
                 break;
             
             case 3: // Voir vos candidatures
-                code = voirCandidature(tNumEtu, tRefStage, tRef, tDpt, tPourvu, tEtu1, tEtu2, tEtu3, tlogEtu, tlogOffre, id, tCandid);
+                if (chargerToutesOffres(s) != 1) {
+                    printf("\nImpossible de charger les offres !\n");
+                    break;
+                }
+                code = voirCandidature(s, id);
                 if (code == -1) printf("Étudiant non trouvé.\n");
                 if (code == -2) printf("Aucun stage affecté trouvé.\n");
                 break;
+
+            case 4: // Annuler les modifications de la session
+                code = annulerTransaction(s);
+                if (code >= 0) printf("\n%d modification(s) annulée(s).\n", code);
+                if (code == -2) printf("\nLe journal est incomplet, annulation impossible !\n");
+                break;
             
             default: // Choix invalide
                 printf("\nChoix non valide !\n");
                 break;
             }
+            signalerEchecsSauvegarde();
             choix = menuEtudiant();
         }
-        code = modificationFichier(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tlogOffre, tNumEtu, tRefStage, tNoteFinal, tlogEtu);
+        validerTransaction();
+        code = publierInstantane(s);
+        if (code == -1) code = modificationFichier(s);
+        else code = demanderSauvegarde();
         if (code == 1) return 1; // Fonction réussi
         if (code == -1) return -1;
     }
@@ -894,40 +1334,31 @@ int globalEtudiant(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEt
 /**
  * \brief Ajoute les notes pour un étudiant dans le tableau.
  * 
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tNoteFinal[] Tableau des moyennes finales des étudiants.
- * \param tlogEtu Taille logique du tableau.
+ * \param s Stockage des données.
  * \return La moyenne calculée si tout s'est bien passé, sinon -1.
  */
-int ajouterNotes(int tNumEtu[], float tNoteFinal[], int *tlogEtu) { 
+int ajouterNotes(Stockage *s) { 
     int idEtu;
     float noteEntreprise, noteRapport, noteSoutenance;
     float moyenne; 
-    int place = -1; 
 
     printf("\nEntrez l'ID de l'étudiant : "); 
-    scanf("%d", &idEtu); 
+    lireEntier(&idEtu); 
 
-    for (int i = 0; i < *tlogEtu; i++) { 
-        if (tNumEtu[i] == idEtu) { 
-            place = i; 
-            break; 
-        } 
-    } 
-    if (place == -1) return -1; // Etudiant non trouvé 
+    if (rechercherEtudiant(s->etudiants.tNumEtu, s->etudiants.tlog, idEtu) == -1) return -1; // Etudiant non trouvé 
 
     printf("Entrez la note d'entreprise : "); 
-    scanf("%f", &noteEntreprise);
+    lireReel(&noteEntreprise);
     if (noteEntreprise <  0 || noteEntreprise > 20) return -2;
     printf("Entrez la note du rapport : "); 
-    scanf("%f", &noteRapport);
+    lireReel(&noteRapport);
     if (noteRapport <  0 || noteRapport > 20) return -3;
     printf("Entrez la note de soutenance : "); 
-    scanf("%f", &noteSoutenance);
+    lireReel(&noteSoutenance);
     if (noteSoutenance <  0 || noteSoutenance > 20) return -4;
 
     moyenne = (noteEntreprise + noteRapport + noteSoutenance) / 3;
-    tNoteFinal[place] = moyenne; 
+    noterEtudiant(s, idEtu, moyenne);
 
     return moyenne; 
 }
@@ -935,18 +1366,48 @@ int ajouterNotes(int tNumEtu[], float tNoteFinal[], int *tlogEtu) {
 /**
  * \brief Affiche les notes des étudiants.
  * 
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tNoteFinal[] Tableau des moyennes finales des étudiants.
- * \param tlogEtu Taille logique du tableau.
- * \return 1 si l'affichage a été effectué correctement, -1 si aucun étudiant n'est à afficher.
+ * \param e Étudiants.
+ * \return 1 si l'affichage a été effectué correctement, -1 si aucun étudiant n'est à afficher, -2 en cas d'erreur d'allocation.
  */
-int afficherNotes(int tNumEtu[], int tRefStage[], float tNoteFinal[], int *tlogEtu) {
-    if (*tlogEtu <= 0) return -1;
+int afficherNotes(Etudiants *e) {
+    Page page;
+    Curseur c;
+    int *tPos, *tCle, i, fin, code = 1;
+
+    if (e->tlog <= 0) return -1;
+    tPos = (int *)malloc((e->tlog + 1) * sizeof(int));
+    tCle = (int *)malloc((e->tlog + 1) * sizeof(int));
+    if (tPos == NULL || tCle == NULL) {
+        free(tPos);
+        free(tCle);
+        return -2; // Problème d'allocation
+    }
+
+    lireCurseur(&c, "Tri (0 : numéro, 1 : meilleure note): ");
+    for (i = 0; i < e->tlog; i++) {
+        tPos[i] = i;
+        tCle[i] = c.tri == 1 ? centiemes(noteEtudiant(e, i)) : e->tNumEtu[i];
+    }
+    code = ordonnerPositions(tPos, e->tlog, tCle, c.tri == 1);
+    free(tCle);
+    if (code == -1) {
+        free(tPos);
+        return -2;
+    }
 
-    printf("\nNUM\tNOTE\n");
-    for (int i = 0; i < *tlogEtu; i++) {
-        printf("%d\t%.2f\n", tNumEtu[i], tNoteFinal[i]);
+    pageInit(&page);
+    pageAjouter(&page, "\nNUM\tNOTE\n");
+    fin = finCurseur(&c, e->tlog);
+    for (int k = c.debut; k < fin; k++) {
+        if (pageNouvelleLigne(&page) == 0) {
+            pageInterrompue(&page, k);
+            break;
+        }
+        i = tPos[k];
+        pageAjouter(&page, "%d\t%.2f\n", e->tNumEtu[i], noteEtudiant(e, i));
     }
+    pageVider(&page);
+    free(tPos);
     return 1;
 }
 
@@ -960,38 +1421,27 @@ int menuJury(void) {
     printf("\nAction :\n");
     printf("\t1. Ajouter des notes\n");
     printf("\t2. Afficher les notes\n");
-    printf("\t3. Quitter\n");
+    printf("\t3. Annuler les modifications de la session\n");
+    printf("\t4. Quitter\n");
     printf("Votre choix: ");
-    scanf("%d", &choix);
+    lireEntier(&choix);
     return choix;
 }
 
 /**
  * \brief Gère les actions du jury.
  * 
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tRefStage[] Tableau des références de stages associés aux étudiants.
- * \param tNoteFinal[] Tableau des moyennes finales des étudiants.
- * \param tlogOffre Taille logique du tableau des offres de stages.
- * \param tmaxOffre Taille physique du tableau des offres de stages.
- * \param tlogEtu Taille logique du tableau d'étudiants.
- * \param tmaxEtu Taille physique du tableau d'étudiants.
+ * \param s Stockage des données.
  * \return 1 si toutes les actions ont été effectuées avec succès, -1 en cas d'erreur.
  */
-int globalJury(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int tNumEtu[], int tRefStage[], float tNoteFinal[], int *tlogOffre, int tmaxOffre, int *tlogEtu, int tmaxEtu) {
-   int choix, code;
+int globalJury(Stockage *s) {
+    int choix, code;
+    debutTransaction();
     choix = menuJury();
-    while (choix!=3) {
+    while (choix!=4) {
         switch (choix) {
         case 1: // Ajouter une offre de stage
-            code = ajouterNotes(tNumEtu, tNoteFinal, tlogEtu);
+            code = ajouterNotes(s);
             if (code == -1) printf("\nL'étudiant n'a pas été trouver !\n");
             if (code == -2) printf("\nLa note d'entreprise est incorrecte !\n");
             if (code == -3) printf("\nLa note de rapport est incorrecte !\n");
@@ -999,17 +1449,28 @@ int globalJury(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[]
             break;
         
         case 2: // Afficher notes
-            code = afficherNotes(tNumEtu, tRefStage, tNoteFinal, tlogEtu);
+            code = afficherNotes(&s->etudiants);
             if (code == -1) printf("Aucun étudiant à afficher.\n");
+            if (code == -2) printf("\nMémoire insuffisante !\n");
+            break;
+
+        case 3: // Annuler les modifications de la session
+            code = annulerTransaction(s);
+            if (code >= 0) printf("\n%d modification(s) annulée(s).\n", code);
+            if (code == -2) printf("\nLe journal est incomplet, annulation impossible !\n");
             break;
 
         default: // Choix invalide
             printf("\nChoix non valide !\n");
             break;
         }
+        signalerEchecsSauvegarde();
         choix = menuJury();
     }
-    code = modificationFichier(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tlogOffre, tNumEtu, tRefStage, tNoteFinal, tlogEtu);
+    validerTransaction();
+    code = publierInstantane(s);
+    if (code == -1) code = modificationFichier(s);
+    else code = demanderSauvegarde();
     if (code == 1) return 1; // Fonction réussi
     else return -1; 
 }
@@ -1028,72 +1489,129 @@ int menuGlobal(void) {
     printf("\t3. Jury\n");
     printf("\t4. Quitter\n");
     printf("Votre choix : ");
-    scanf("%d", &choix);
+    lireEntier(&choix);
     return choix;
 }
 
+/**
+ * \brief Signale les sauvegardes automatiques qui ont échoué depuis le dernier signalement.
+ */
+void signalerEchecsSauvegarde(void) {
+    int cause, nb = echecsSauvegardeAuto(&cause);
+
+    if (nb == 0) return;
+    printf("\nLa sauvegarde automatique a échoué (%d fois) !\n", nb);
+    if (cause == -2) printf("Un autre processus a modifié les mêmes lignes : les modifications de cette session ne sont pas enregistrées.\n");
+    else if (cause == -3) printf("Le verrou des fichiers de données n'a pas pu être pris.\n");
+}
+
+/**
+ * \brief Affiche les violations trouvées par la vérification des données.
+ * 
+ * \param r Rapport de la vérification.
+ */
+void afficherRapport(Rapport *r) {
+    const char *tNoms[NB_VIOLATIONS] = {
+        "Etudiant(s) affecté(s) à un stage inexistant",
+        "Etudiant(s) affecté(s) à un stage non pourvu",
+        "Stage(s) pourvu(s) sans étudiant affecté",
+        "Stage(s) affecté(s) à plusieurs étudiants",
+        "Candidat(s) inconnu(s)",
+        "Stage(s) dont le nombre de candidats est faux",
+        "Référence(s) en double",
+        "Numéro(s) d'étudiant en double",
+        "Liste(s) d'attente d'un stage inexistant ou pourvu",
+        "Liste(s) d'attente d'un stage qui a encore des places",
+        "Etudiant(s) en attente inconnu(s) ou déjà affecté(s)",
+        "Etudiant(s) en attente en double ou déjà candidat(s)"
+    };
+
+    for (int sorte = 0; sorte < NB_VIOLATIONS; sorte++) {
+        if (r->tNb[sorte] == 0) continue;
+        printf("\n%s : %ld (", tNoms[sorte], r->tNb[sorte]);
+        for (long e = 0; e < r->tNb[sorte] && e < NB_EXEMPLES; e++) printf(e == 0 ? "%d" : ", %d", r->tExemples[sorte][e]);
+        printf(r->tNb[sorte] > NB_EXEMPLES ? ", ...)" : ")");
+    }
+    printf("\n");
+}
+
 /**
  * \brief Gère les actions principales de l'application.
  * 
  * \param choix Le choix de l'utilisateur.
  * \param code Le code de retour des différentes fonctions
- * \param tRef[] Tableau des références des stages.
- * \param tDpt[] Tableau des départements associés aux stages.
- * \param tPourvu[] Tableau indiquant si un stage est pourvu.
- * \param tCandid[] Tableau contenant le nombre de candidatures pour chaque stage.
- * \param tEtu1[] Tableau contenant l'ID 1 de l'étudiant qui candidate aux stages.
- * \param tEtu2[] Tableau contenant l'ID 2 de l'étudiant qui candidate aux stages.
- * \param tEtu3[] Tableau contenant l'ID 3 de l'étudiant qui candidate aux stages.
- * \param tNumEtu[] Tableau des numéros des étudiants.
- * \param tRefStage[] Tableau des références de stages associés aux étudiants.
- * \param tNoteFinal[] Tableau des moyennes finales des étudiants.
- * \param tlogOffre Taille logique du tableau des offres de stages.
- * \param tmaxOffre Taille physique du tableau des offres de stages.
- * \param tlogEtu Taille logique du tableau d'étudiants.
- * \param tmaxEtu Taille physique du tableau d'étudiants.
+ * \param s Stockage des données (offres et étudiants).
  */
 void global(void) {
-    int choix, code;
-    // Tableaux Offres De Stages
-    int tRef[200]={0}, tDpt[200]={0}, tPourvu[200]={0}, tCandid[200]={0}, tEtu1[200]={0}, tEtu2[200]={0}, tEtu3[200]={0}, tmaxOffre=200, tlogOffre=0;
-    // Tableaux Liste Etudiants
-    int tNumEtu[200]={0}, tRefStage[200]={0}, tmaxEtu=200, tlogEtu=0;
-    float tNoteFinal[200];
+    int choix, code, nbDepartements;
+    long nbViolations;
+    Stockage s;
+    Rapport rapport;
 
-    code = remplirOffreStage(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, &tlogOffre, tmaxOffre);
+    if (creerStockageDonnees(&s, MARGE_OFFRES) == -1) {
+        printf("\nMémoire insuffisante !\n");
+        exit(1);
+    }
+
+    // Chargement simultané des deux fichiers
+    code = chargerStockage(&s);
     if (code == -1) {
         printf("\nUne erreur est survenue lors du chargement du fichier (Offre Stage) !\n");
         exit(1); // Termine tout
     }
-
-    code = remplirListeEtudiants(tNumEtu, tRefStage, tNoteFinal, &tlogEtu, tmaxEtu);
-    if (code == -1) {
+    if (code == -2) {
         printf("\nUne erreur est survenue lors du chargement du fichier (Liste) !\n");
         exit(1);
-    } else if (code == -2) {
-        printf("\nLe fichier étudiant est vide !\n");
+    } else if (code == -3) {
+        printf("\nLe fichier étudiant contient plus d'étudiants que prévu !\n");
+        exit(1);
+    } else if (code == -4) {
+        printf("\nMémoire insuffisante pour les listes d'attente !\n");
         exit(1);
+    } else if (code == -5) {
+        printf("\nLe fichier des offres contient plus d'offres que prévu !\n");
+        exit(1);
+    } else if (code == 2) {
+        printf("\nAttention : des listes d'attente invalides ont été ignorées !\n");
+    }
+
+    // Vérification de la cohérence des données chargées
+    nbViolations = verifierDonnees(&s, &rapport);
+    if (nbViolations == -1) printf("\nAttention : mémoire insuffisante, la cohérence des données n'a pas été vérifiée !\n");
+    if (nbViolations > 0) {
+        printf("\nAttention : %ld incohérence(s) dans les données !", nbViolations);
+        afficherRapport(&rapport);
     }
+    nbDepartements = departementsNonCharges();
+    if (nbDepartements > 0) printf("\nLes offres de %d département(s) non chargé(s) n'ont pas été vérifiées (vérification complète : --verifier).\n", nbDepartements);
+
+    // Sauvegarde automatique du dernier instantané publié (fin de chaque partie)
+    publierInstantane(&s);
+    if (demarrerSauvegardeAuto() == -1) printf("\nSauvegarde automatique indisponible, sauvegarde à la sortie de chaque partie.\n");
 
     choix = menuGlobal();
     while(choix!=4) {
         switch (choix) {
             case 1: // Partie Responsable
-                code = globalResponsable(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tNumEtu, tRefStage, tNoteFinal, &tlogOffre, tmaxOffre, &tlogEtu, tmaxEtu);
+                code = globalResponsable(&s);
                 break;
             
             case 2: // Partie Etudiants
-                code = globalEtudiant(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tNumEtu, tRefStage, tNoteFinal, &tlogOffre, tmaxOffre, &tlogEtu, tmaxEtu);
+                code = globalEtudiant(&s);
                 break;
             
             case 3: // Partie Jury
-                code = globalJury(tRef, tDpt, tPourvu, tCandid, tEtu1, tEtu2, tEtu3, tNumEtu, tRefStage, tNoteFinal, &tlogOffre, tmaxOffre, &tlogEtu, tmaxEtu);
+                code = globalJury(&s);
                 break;
 
             default: // Choix invalide
                 printf("\nChoix non valide !\n");
                 break;
         }
+        signalerEchecsSauvegarde();
         choix = menuGlobal();
     }
+    arreterSauvegardeAuto();
+    signalerEchecsSauvegarde(); // Dernière sauvegarde
+    libererStockage(&s);
 }
\ No newline at end of file
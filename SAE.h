@@ -1,50 +1,104 @@
 /**
  * \file SAE.h
- * \brief Fichier contenant les déclarations des fonctions du programme de gestion des stages.
+ * \brief Déclarations de l'interface en mode texte (menus, saisies, affichages) de la gestion des stages.
  *
  * \authors MIOTTO Quentin, PICHOT-MOÏSE Mathéo
  * \date 15 Octobre 2024
  */
-#include <stdio.h>
-#include <stdlib.h>
+#include "SAECore.h"
+#include <sys/wait.h>
+#include <errno.h>
 
-// Remplir Tableaux
-    int remplirOffreStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog, int tmax);
-    int remplirListeEtudiants(int tNumEtu[], int tRefStage[], float tNoteFInal[], int *tlog, int tmax);
+#define SAISIE_NORMALE 0 // Saisies lues au clavier
+#define SAISIE_ENREGISTREMENT 1 // Saisies lues au clavier et enregistrées
+#define SAISIE_REJEU 2 // Saisies rejouées à leur vitesse d'origine
+#define SAISIE_REJEU_MAX 3 // Saisies rejouées sans attente
+#define VERSION_SAISIES 1 // Format des enregistrements, à augmenter à chaque changement de la numérotation des menus
 
-// Sauvegarde
-    int modificationFichier(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog, int tNumEtu[], int tRefStage[], float tNoteFInal[], int *tlogEtu);
+#define TAILLE_PAGE 20 // Nombre de lignes affichées avant de demander la suite
+#define TAILLE_TAMPON 65536 // Taille du tampon de sortie des listes
+
+/**
+ * \brief Tampon de sortie d'une liste paginée.
+ */
+typedef struct {
+    char *tampon; // Lignes formatées en attente d'écriture (tampon statique réutilisé)
+    int lg; // Nombre d'octets utilisés dans le tampon
+    int lignes; // Nombre de lignes de la page en cours
+} Page;
+
+/**
+ * \brief Partie d'une liste à afficher : première ligne, nombre de lignes et ordre.
+ *
+ * Une liste interrompue indique la ligne où elle s'est arrêtée ; la redemander
+ * avec cette ligne comme début reprend l'affichage à cet endroit.
+ */
+typedef struct {
+    int debut; // Première ligne affichée (0 : la première)
+    int limite; // Nombre de lignes au plus (0 : toutes)
+    int tri; // Ordre des lignes (0 : ordre naturel de la liste)
+} Curseur;
+
+// Saisies
+    double maintenant(void);
+    int demarrerEnregistrement(const char *chemin);
+    int demarrerRejeu(const char *chemin, int vitesseMax);
+    int saisieValide(char type, const char texte[]);
+    int lireSaisie(char type, char texte[]);
+    int lireEntier(int *val);
+    int lireReel(float *val);
+    int lireTexte(char texte[]);
+    void terminerSaisies(void);
+    int rejouerPlusieurs(int nb, char *tChemins[], int vitesseMax);
+
+// Affichage paginé
+    void pageInit(Page *p);
+    void pageVider(Page *p);
+    void pageAjouter(Page *p, const char *format, ...);
+    int pageNouvelleLigne(Page *p);
+    void lireCurseur(Curseur *c, const char *questionTri);
+    int finCurseur(Curseur *c, int nb);
+    int ordonnerPositions(int tPos[], int nb, int tCle[], int decroissant);
+    int ordonnerOffres(int tPos[], int nb, int tri, Offres *o);
+    void pageInterrompue(Page *p, int ligne);
 
 // Responsable
-    int afficherTableau(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog, int tmax);
-    int afficherStagesPourvus(int tRef[], int tDpt[], int tPourvu[], int *tlogOffre, int tNumEtu[], int tRefStage[], int *tlogEtu);
-    int afficherStagesNonPourvus(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int *tlog);
-    int afficherEtudiantsSansStage(int tNumEtu[], int tRefStage[], int *tlogEtu);
-    int rechercherStage(int tRef[], int tDpt[], int tCandid[], int *tlog);
-    int afficherInfoStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog);
-    int ajoutStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog, int tmax);
-    int decalerAgauche(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog, int ref);
-    int supprimerStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog);
-    void StagesDispo(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int *tlog);
-    int affecterEtudiant(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlog, int tNumEtu[], int tRefStage[], float tNoteFInal[], int *tlogEtu);
+    int afficherTableau(Offres *o);
+    int afficherStagesPourvus(Stockage *s);
+    int afficherStagesNonPourvus(Offres *o);
+    int afficherEtudiantsSansStage(Etudiants *e);
+    int rechercherStage(Stockage *s);
+    int afficherPlageRef(Stockage *s);
+    int afficherVoisinsRef(Offres *o);
+    int afficherInfoStage(Stockage *s);
+    int ajoutStage(Stockage *s);
+    int supprimerStage(Stockage *s);
+    void StagesDispo(Offres *o);
+    int afficherCandidatsClasses(Stockage *s, int pos);
+    int afficherMeilleursSansStage(Etudiants *e);
+    int afficherOffresCandidatSansStage(Stockage *s);
+    int simulerPolitiques(Stockage *s);
+    int affecterEtudiant(Stockage *s);
     int menuResponsable(void);
-    int globalResponsable(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int tNumEtu[], int tRefStage[], float tNoteFInal[], int *tlogOffre, int tmaxOffre, int *tlogEtu, int tmaxEtu);
+    int globalResponsable(Stockage *s);
 
 // Etudiant
-    int listeStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int *tlogOffre);
-    int candidaterStage(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlogOffre, int *tlogEtu, int tNumEtu[], int etudiantID);
-    int verifieLogin(int id, int tNumEtu[], int tlogEtu);
+    int listeStage(Offres *o);
+    int candidaterStage(Stockage *s, int etudiantID);
+    int verifieLogin(int id, Etudiants *e);
     int login(void);
     int menuEtudiant(void);
-    int globalEtudiant(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int tNumEtu[], int tRefStage[], float tNoteFInal[], int *tlogOffre, int tmaxOffre, int *tlogEtu, int tmaxEtu);
+    int globalEtudiant(Stockage *s);
 
 // Jury
-    int ajouterNotes(int tNumEtu[], float tNoteFInal[], int *tlogEtu);
-    int afficherNotes(int tNumEtu[], int tRefStage[], float tNoteFInal[], int *tlogEtu);
-    int voirCandidature(int tNumEtu[], int tRefStage[], int tRef[], int tDpt[], int tPourvu[], int tEtu1[], int tEtu2[], int tEtu3[], int *tlogEtu, int *tlogOffre, int etudiantID, int tCandid[]);
+    int ajouterNotes(Stockage *s);
+    int afficherNotes(Etudiants *e);
+    int voirCandidature(Stockage *s, int etudiantID);
     int menuJury(void);
-    int globalJury(int tRef[], int tDpt[], int tPourvu[], int tCandid[], int tEtu1[], int tEtu2[], int tEtu3[], int tNumEtu[], int tRefStage[], float tNoteFInal[], int *tlogOffre, int tmaxOffre, int *tlogEtu, int tmaxEtu);
+    int globalJury(Stockage *s);
 
 // Global
     int menuSelection(void);
-    void global(void);
\ No newline at end of file
+    void signalerEchecsSauvegarde(void);
+    void afficherRapport(Rapport *r);
+    void global(void);
@@ -0,0 +1,4240 @@
+/**
+ * \file SAECore.c
+ * \brief Cœur de la gestion des stages : chargement, index, modifications, sauvegarde.
+ * \authors MIOTTO Quentin, PICHOT-MOÏSE Mathéo
+ * \date 15 Octobre 2024
+ */
+#include "SAECore.h"
+
+// Journal d'annulation de la transaction en cours
+static EntreeJournal *tJournal = NULL;
+static int tlogJournal = 0, tmaxJournal = 0;
+static int transactionActive = 0; // 1 si les modifications sont journalisées
+static int journalIncomplet = 0; // 1 si une entrée n'a pas pu être enregistrée
+
+// Version des données et dernier instantané publié
+static int version = 0;
+static Instantane *instantanePublie = NULL;
+static pthread_mutex_t verrouInstantane = PTHREAD_MUTEX_INITIALIZER;
+
+// Fichiers des offres découpés par département
+static Shard *tShards = NULL;
+static int tlogShards = 0, tmaxShards = 0;
+static int modeShards = 0; // 1 si les offres sont découpées par département
+static int manifesteModifie = 0; // 1 si la liste des départements a changé
+static pthread_mutex_t verrouShards = PTHREAD_MUTEX_INITIALIZER;
+
+// Sauvegarde automatique en arrière-plan
+static pthread_t filSauvegarde;
+static pthread_mutex_t verrouSauvegarde = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t condSauvegarde = PTHREAD_COND_INITIALIZER;
+static int sauvegardeActive = 0, arretSauvegarde = 0, sauvegardeDemandee = 0;
+static int versionSauvee = 0; // Version des données présente dans les fichiers
+static int echecsSauvegarde = 0; // Sauvegardes échouées pas encore signalées à l'interface
+static int causeEchecSauvegarde = 0; // Code rendu par sauvegarderDonnees lors du dernier échec
+
+// Sauvegarde concurrente entre processus
+static Modification *tModifs = NULL; // Lignes modifiées depuis la dernière sauvegarde
+static int tlogModifs = 0, tmaxModifs = 0;
+static int modifsIncompletes = 0; // 1 si une modification n'a pas pu être notée
+static pthread_mutex_t verrouModifs = PTHREAD_MUTEX_INITIALIZER;
+static int estampilleBase = 0; // Estampille des fichiers d'où viennent les données en mémoire
+static int memoireAJour = 1; // 0 si les fichiers contiennent des lignes d'autres processus absentes de la mémoire
+static pthread_mutex_t verrouDisque = PTHREAD_MUTEX_INITIALIZER; // Une seule sauvegarde à la fois dans le processus
+
+// Flux des événements de modification
+static int fdEvenements = -1; // Flux ouvert, -1 tant qu'il ne l'est pas
+static char *tEvenements = NULL; // Événements de la transaction en cours, un par ligne
+static int lgEvenements = 0, tmaxEvenements = 0;
+
+/**
+ * \brief Charge un fichier entier en mémoire.
+ * 
+ * \param chemin Chemin du fichier à lire.
+ * \param taille Taille du fichier en octets.
+ * \return Le contenu du fichier terminé par '\\0', NULL en cas d'erreur (à libérer avec free).
+ */
+char *chargerFichier(const char *chemin, long *taille) {
+    FILE *flot;
+    char *texte;
+
+    flot = fopen(chemin, "rb");
+    if (flot == NULL) return NULL; // Erreur lors du chargement
+
+    fseek(flot, 0, SEEK_END);
+    *taille = ftell(flot);
+    fseek(flot, 0, SEEK_SET);
+    if (*taille < 0) *taille = 0;
+
+    texte = (char *)malloc(*taille + 1);
+    if (texte == NULL) {
+        fclose(flot);
+        return NULL; // Problème d'allocation
+    }
+    *taille = fread(texte, 1, *taille, flot);
+    texte[*taille] = '\0';
+    fclose(flot);
+    return texte;
+}
+
+/**
+ * \brief Lit un entier dans un morceau de texte sans en dépasser la fin.
+ * 
+ * \param p Position de lecture, avancée après l'entier lu.
+ * \param fin Fin du morceau de texte.
+ * \param val Entier lu.
+ * \return 1 si un entier a été lu, 0 sinon.
+ */
+int lireEntierTexte(const char **p, const char *fin, int *val) {
+    char *suite;
+
+    while (*p < fin && isspace((unsigned char)**p)) (*p)++;
+    if (*p >= fin) return 0; // Fin du morceau
+
+    *val = (int)strtol(*p, &suite, 10);
+    if (suite == *p) return 0; // Pas un entier
+    *p = suite;
+    return 1;
+}
+
+/**
+ * \brief Lit un réel dans un morceau de texte sans en dépasser la fin.
+ * 
+ * \param p Position de lecture, avancée après le réel lu.
+ * \param fin Fin du morceau de texte.
+ * \param val Réel lu.
+ * \return 1 si un réel a été lu, 0 sinon.
+ */
+int lireReelTexte(const char **p, const char *fin, float *val) {
+    char *suite;
+
+    while (*p < fin && isspace((unsigned char)**p)) (*p)++;
+    if (*p >= fin) return 0; // Fin du morceau
+
+    *val = strtof(*p, &suite);
+    if (suite == *p) return 0; // Pas un réel
+    *p = suite;
+    return 1;
+}
+
+/**
+ * \brief Analyse les offres de stages d'un morceau de "offrestage.don".
+ * 
+ * \param arg Morceau à analyser (Morceau *), ses colonnes sont remplies.
+ * \return NULL.
+ */
+void *analyserMorceauOffres(void *arg) {
+    Morceau *m = (Morceau *)arg;
+    const char *p = m->debut;
+    int ref, dept, pourvu, candid, tEtu[3];
+
+    m->tlog = 0;
+    while (m->tlog < m->tmax && lireEntierTexte(&p, m->fin, &ref) == 1) {
+        if (ref < 1000) continue; // Valeur ignorée
+
+        if (lireEntierTexte(&p, m->fin, &dept) == 0) break;
+        if (lireEntierTexte(&p, m->fin, &pourvu) == 0) break;
+        if (lireEntierTexte(&p, m->fin, &candid) == 0) break;
+
+        tEtu[0] = tEtu[1] = tEtu[2] = 0;
+        if (candid >= 1 && candid <= 3) {
+            int lu = 0;
+            while (lu < candid && lireEntierTexte(&p, m->fin, &tEtu[lu]) == 1) lu++;
+            if (lu < candid) break; // Enregistrement tronqué
+        }
+
+        m->tCol[0][m->tlog] = ref;
+        m->tCol[1][m->tlog] = dept;
+        m->tCol[2][m->tlog] = pourvu;
+        m->tCol[3][m->tlog] = candid;
+        m->tCol[4][m->tlog] = tEtu[0];
+        m->tCol[5][m->tlog] = tEtu[1];
+        m->tCol[6][m->tlog] = tEtu[2];
+        m->tlog++;
+    }
+    return NULL;
+}
+
+/**
+ * \brief Analyse les étudiants d'un morceau de "etudiants.don".
+ * 
+ * \param arg Morceau à analyser (Morceau *), ses colonnes sont remplies.
+ * \return NULL.
+ */
+void *analyserMorceauEtudiants(void *arg) {
+    Morceau *m = (Morceau *)arg;
+    const char *p = m->debut;
+    int num, ref;
+    float note;
+
+    m->tlog = 0;
+    m->depasse = 0;
+    while (lireEntierTexte(&p, m->fin, &num) == 1) {
+        if (lireEntierTexte(&p, m->fin, &ref) == 0 || lireReelTexte(&p, m->fin, &note) == 0) break;
+        if (m->tlog == m->tmax) {
+            m->depasse = 1;
+            break;
+        }
+        m->tCol[0][m->tlog] = num;
+        m->tCol[1][m->tlog] = ref;
+        m->tNote[m->tlog] = note;
+        m->tlog++;
+    }
+    return NULL;
+}
+
+/**
+ * \brief Indique si une ligne commence un enregistrement d'offre ("REF DPT" : deux entiers).
+ * 
+ * \param p Début de la ligne.
+ * \param fin Fin du texte.
+ * \return 1 si la ligne contient exactement deux entiers, 0 sinon.
+ */
+int estDebutOffre(const char *p, const char *fin) {
+    const char *finLigne = p;
+    int val, nb = 0;
+
+    while (finLigne < fin && *finLigne != '\n') finLigne++;
+    while (nb < 3 && lireEntierTexte(&p, finLigne, &val) == 1) nb++;
+    return nb == 2;
+}
+
+/**
+ * \brief Donne le début du premier enregistrement situé à partir d'une position.
+ * 
+ * \param p Position de départ (quelconque).
+ * \param fin Fin du texte.
+ * \param offres 1 pour "offrestage.don" (enregistrements de longueur variable), 0 pour "etudiants.don" (une ligne par étudiant).
+ * \return Le début de l'enregistrement suivant, ou fin.
+ */
+const char *debutEnregistrement(const char *p, const char *fin, int offres) {
+    while (p < fin) {
+        while (p < fin && *p != '\n') p++; // Aller au début de la ligne suivante
+        if (p < fin) p++;
+        if (offres == 0 || p >= fin || estDebutOffre(p, fin) == 1) return p;
+    }
+    return fin;
+}
+
+/**
+ * \brief Donne le nombre de fils à utiliser pour analyser un texte.
+ * 
+ * \param taille Taille du texte en octets.
+ * \return Le nombre de fils (1 pour les petits fichiers).
+ */
+int nbFilsChargement(long taille) {
+    long nb = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (nb < 1) nb = 1;
+    if (nb > NB_FILS_MAX) nb = NB_FILS_MAX;
+    if (taille / TAILLE_MORCEAU_MIN < nb) nb = taille / TAILLE_MORCEAU_MIN;
+    if (nb < 1) nb = 1;
+    return (int)nb;
+}
+
+/**
+ * \brief Découpe un texte en morceaux alignés sur les enregistrements et les analyse en parallèle.
+ * 
+ * Chaque morceau est analysé par un fil dans ses propres colonnes ; les résultats
+ * sont ensuite recopiés dans l'ordre du fichier à la fin des tableaux de destination.
+ * 
+ * \param texte Texte à analyser.
+ * \param taille Taille du texte.
+ * \param o Offres de destination (NULL pour des étudiants).
+ * \param e Étudiants de destination (NULL pour des offres).
+ * \return 1 si tout s'est bien passé, -1 en cas d'erreur d'allocation, -2 si les tableaux sont trop petits,
+ * -3 si une valeur ne tient pas dans sa colonne (seuls les enregistrements qui la précèdent sont gardés).
+ */
+int analyserTexte(const char *texte, long taille, Offres *o, Etudiants *e) {
+    Morceau tMorceaux[NB_FILS_MAX];
+    pthread_t tFils[NB_FILS_MAX];
+    int offres = o != NULL, nbFils = nbFilsChargement(taille), nbCol = offres == 1 ? 7 : 2;
+    int *tlog = offres == 1 ? &o->tlog : &e->tlog, tmax = offres == 1 ? o->tmax : e->tmax;
+    int code = 1, place = tmax - *tlog, cap, *bloc;
+    const char *fin = texte + taille, *debut = texte;
+    void *(*analyser)(void *) = offres == 1 ? analyserMorceauOffres : analyserMorceauEtudiants;
+
+    for (int k = 0; k < nbFils; k++) {
+        tMorceaux[k].debut = debut;
+        if (k == nbFils - 1) tMorceaux[k].fin = fin;
+        else tMorceaux[k].fin = debutEnregistrement(texte + taille * (k + 1) / nbFils, fin, offres);
+        if (tMorceaux[k].fin < debut) tMorceaux[k].fin = debut;
+        debut = tMorceaux[k].fin;
+
+        // Un enregistrement occupe au moins 4 octets : inutile de réserver plus
+        cap = (int)((tMorceaux[k].fin - tMorceaux[k].debut) / 4 + 1);
+        if (cap > place + 1) cap = place + 1; // +1 pour détecter un dépassement
+        tMorceaux[k].tmax = cap;
+        tMorceaux[k].tlog = 0;
+        tMorceaux[k].depasse = 0;
+        bloc = (int *)malloc((size_t)cap * (nbCol + 1) * sizeof(int));
+        if (bloc == NULL) code = -1;
+        for (int c = 0; c < nbCol; c++) tMorceaux[k].tCol[c] = bloc == NULL ? NULL : bloc + c * cap;
+        tMorceaux[k].tNote = bloc == NULL ? NULL : (float *)(bloc + nbCol * cap);
+    }
+
+    if (code == 1) {
+        for (int k = 1; k < nbFils; k++) {
+            if (pthread_create(&tFils[k], NULL, analyser, &tMorceaux[k]) != 0) {
+                analyser(&tMorceaux[k]); // Pas de fil disponible : analyse sur place
+                tFils[k] = pthread_self();
+            }
+        }
+        analyser(&tMorceaux[0]);
+        for (int k = 1; k < nbFils; k++) {
+            if (!pthread_equal(tFils[k], pthread_self())) pthread_join(tFils[k], NULL);
+        }
+
+        // Fusion dans l'ordre du fichier, dans les colonnes compactes
+        for (int k = 0; k < nbFils && code != -3; k++) {
+            Morceau *m = &tMorceaux[k];
+            int n = m->tlog, tLigne[7];
+            if (m->depasse == 1 || n > tmax - *tlog) {
+                code = -2; // Trop d'enregistrements : seuls les premiers sont gardés
+                if (n > tmax - *tlog) n = tmax - *tlog;
+            }
+            for (int r = 0; r < n; r++) {
+                for (int c = 0; c < nbCol; c++) tLigne[c] = m->tCol[c][r];
+                if (offres == 1) {
+                    if (tLigne[1] < DPT_MIN || tLigne[1] > DPT_MAX || (tLigne[2] != 0 && tLigne[2] != 1) || tLigne[3] < 0 || tLigne[3] > CANDID_MAX) {
+                        code = -3; // Valeur hors limites
+                        break;
+                    }
+                    ecrireLigneOffre(o, *tlog, tLigne);
+                }
+                else {
+                    if (noteRepresentable(m->tNote[r]) == 0) {
+                        code = -3; // Note hors limites
+                        break;
+                    }
+                    e->tNumEtu[*tlog] = tLigne[0];
+                    e->tRefStage[*tlog] = tLigne[1];
+                    fixerNote(e, *tlog, m->tNote[r]);
+                }
+                (*tlog)++;
+            }
+        }
+    }
+
+    for (int k = 0; k < nbFils; k++) free(tMorceaux[k].tCol[0]);
+    return code;
+}
+
+/**
+ * \brief Lit les offres de stages d'un fichier et les ajoute à la fin des tableaux.
+ * 
+ * \param chemin Chemin du fichier à lire.
+ * \param o Offres de stage (complétées).
+ * \return 1 si tout s'est bien passé, -1 en cas d'erreur d'ouverture ou de valeur hors limites, -2 si les tableaux sont trop petits (offres en trop ignorées).
+ */
+int lireFichierOffres(const char *chemin, Offres *o) {
+    long taille;
+    char *texte;
+    int code;
+
+    texte = chargerFichier(chemin, &taille);
+    if (texte == NULL) return -1; // Erreur lors du chargement
+
+    code = analyserTexte(texte, taille, o, NULL);
+    free(texte);
+    if (code == -1 || code == -3) return -1;
+    if (code == -2) return -2; // Tableau trop petit
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Remplit les tableaux avec les informations des offres de stages.
+ * 
+ * Si le manifeste "DATA/offres/manifeste.don" existe, seule la liste des départements
+ * est lue : leurs offres seront chargées à la demande (voir chargerDepartement).
+ * Sinon les offres sont lues dans "offrestage.don".
+ * 
+ * \param o Offres de stage à remplir.
+ * \return 1 si tout s'est bien passé, -1 en cas d'erreur de lecture, -2 si le tableau est trop petit.
+ */
+int remplirOffreStage(Offres *o) {
+    int code;
+
+    code = lireManifeste();
+    if (code == -1) return -1; // Manifeste illisible
+    if (code == 1) return 1; // Mode découpé : rien à lire avant la première demande
+
+    code = lireFichierOffres(FICHIER_OFFRES, o);
+    if (code != 1) return code; // Fichier illisible, ou offres en trop : rien ne doit être sauvegardé
+    return trierOffres(o);
+}
+
+/**
+ * \brief Remplit les tableaux avec les informations des étudiants à partir d'un fichier.
+ * 
+ * \param e Étudiants à remplir.
+ * \return 1 si tout s'est bien passé, -1 en cas d'erreur de lecture, -2 si le tableau est trop petit.
+ */
+int remplirListeEtudiants(Etudiants *e) {
+    return lireFichierEtudiants(FICHIER_ETUDIANTS, e);
+}
+
+/**
+ * \brief Lit les étudiants d'un fichier et les ajoute à la fin des tableaux.
+ * 
+ * \param chemin Chemin du fichier à lire.
+ * \param e Étudiants (complétés).
+ * \return 1 si tout s'est bien passé, -1 en cas d'erreur de lecture ou de note hors limites, -2 si le tableau est trop petit.
+ */
+int lireFichierEtudiants(const char *chemin, Etudiants *e) {
+    long taille;
+    char *texte;
+    int code;
+
+    texte = chargerFichier(chemin, &taille);
+    if (texte == NULL) return -1; // Erreur lors du chargement
+
+    code = analyserTexte(texte, taille, NULL, e);
+    free(texte);
+    if (code == -1 || code == -3) return -1;
+    if (code == -2) return -2; // Tableau trop petit
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Fil de chargement des offres de stages (voir remplirOffreStage).
+ * 
+ * \param arg Tableaux à remplir (Chargement *).
+ * \return NULL.
+ */
+void *chargerOffres(void *arg) {
+    Chargement *c = (Chargement *)arg;
+    c->code = remplirOffreStage(c->o);
+    return NULL;
+}
+
+/**
+ * \brief Fil de chargement des étudiants (voir remplirListeEtudiants).
+ * 
+ * \param arg Tableaux à remplir (Chargement *).
+ * \return NULL.
+ */
+void *chargerEtudiants(void *arg) {
+    Chargement *c = (Chargement *)arg;
+    c->code = remplirListeEtudiants(c->e);
+    return NULL;
+}
+
+/**
+ * \brief Indique si une offre est pourvue.
+ * 
+ * \param o Offres de stage.
+ * \param i Position de l'offre.
+ * \return 1 si l'offre est pourvue, 0 sinon.
+ */
+int pourvuOffre(Offres *o, int i) {
+    return (int)(o->tBitsPourvu[i / 64] >> (i % 64)) & 1;
+}
+
+/**
+ * \brief Marque une offre pourvue ou non pourvue.
+ * 
+ * \param o Offres de stage.
+ * \param i Position de l'offre.
+ * \param pourvu 1 si l'offre est pourvue, 0 sinon.
+ */
+void fixerPourvu(Offres *o, int i, int pourvu) {
+    unsigned long long bit = 1ULL << (i % 64);
+
+    if (pourvu == 1) o->tBitsPourvu[i / 64] |= bit;
+    else o->tBitsPourvu[i / 64] &= ~bit;
+}
+
+/**
+ * \brief Donne le nombre de candidats d'une offre.
+ * 
+ * \param o Offres de stage.
+ * \param i Position de l'offre.
+ * \return Le nombre de candidats.
+ */
+int candidOffre(Offres *o, int i) {
+    return o->tNbCandid[i];
+}
+
+/**
+ * \brief Change le nombre de candidats d'une offre.
+ * 
+ * \param o Offres de stage.
+ * \param i Position de l'offre.
+ * \param nb Nombre de candidats (0 à CANDID_MAX).
+ */
+void fixerCandid(Offres *o, int i, int nb) {
+    o->tNbCandid[i] = (unsigned char)nb;
+}
+
+/**
+ * \brief Donne le département d'une offre.
+ * 
+ * \param o Offres de stage.
+ * \param i Position de l'offre.
+ * \return Le numéro du département.
+ */
+int dptOffre(Offres *o, int i) {
+    return o->tNumDpt[i];
+}
+
+/**
+ * \brief Change le département d'une offre.
+ * 
+ * \param o Offres de stage.
+ * \param i Position de l'offre.
+ * \param dpt Numéro du département (DPT_MIN à DPT_MAX).
+ */
+void fixerDpt(Offres *o, int i, int dpt) {
+    o->tNumDpt[i] = (short)dpt;
+}
+
+/**
+ * \brief Donne la note finale d'un étudiant.
+ * 
+ * \param e Étudiants.
+ * \param i Position de l'étudiant.
+ * \return La note finale (-1 : pas de note).
+ */
+float noteEtudiant(Etudiants *e, int i) {
+    return e->tNote[i] / 100.0f;
+}
+
+/**
+ * \brief Change la note finale d'un étudiant (gardée au centième, voir centiemes).
+ * 
+ * \param e Étudiants.
+ * \param i Position de l'étudiant.
+ * \param note Note finale, représentable (voir noteRepresentable).
+ */
+void fixerNote(Etudiants *e, int i, float note) {
+    e->tNote[i] = (short)centiemes(note);
+}
+
+/**
+ * \brief Indique si une note tient dans la colonne des notes (centièmes sur 16 bits).
+ * 
+ * \param note Note à tester.
+ * \return 1 si la note est représentable, 0 sinon.
+ */
+int noteRepresentable(float note) {
+    int c;
+
+    if (!(note > -1000 && note < 1000)) return 0; // Hors limites, ou pas un nombre
+    c = centiemes(note);
+    return c >= SHRT_MIN && c <= SHRT_MAX;
+}
+
+/**
+ * \brief Lit une ligne d'offre dans le format des fichiers.
+ * 
+ * \param o Offres de stage.
+ * \param i Position de l'offre.
+ * \param tLigne[] Tableau (de taille 7) rempli avec REF, DPT, POURVU, CANDID, ETU1, ETU2, ETU3.
+ */
+void lireLigneOffre(Offres *o, int i, int tLigne[]) {
+    tLigne[0] = o->tRef[i];
+    tLigne[1] = dptOffre(o, i);
+    tLigne[2] = pourvuOffre(o, i);
+    tLigne[3] = candidOffre(o, i);
+    tLigne[4] = o->tEtu1[i];
+    tLigne[5] = o->tEtu2[i];
+    tLigne[6] = o->tEtu3[i];
+}
+
+/**
+ * \brief Écrit une ligne d'offre donnée dans le format des fichiers.
+ * 
+ * \param o Offres de stage.
+ * \param i Position de l'offre.
+ * \param tLigne[] REF, DPT, POURVU, CANDID, ETU1, ETU2, ETU3 (valeurs représentables).
+ */
+void ecrireLigneOffre(Offres *o, int i, int tLigne[]) {
+    o->tRef[i] = tLigne[0];
+    fixerDpt(o, i, tLigne[1]);
+    fixerPourvu(o, i, tLigne[2]);
+    fixerCandid(o, i, tLigne[3]);
+    o->tEtu1[i] = tLigne[4];
+    o->tEtu2[i] = tLigne[5];
+    o->tEtu3[i] = tLigne[6];
+}
+
+/**
+ * \brief Alloue des colonnes d'offres vides.
+ * 
+ * Bloc chaud : POURVU (mots de 64 bits), REF, CANDID ; bloc froid : ETU1 à ETU3, DPT.
+ * 
+ * \param o Offres à initialiser (à libérer avec libererOffres).
+ * \param tmax Capacité des colonnes.
+ * \return 1 si l'allocation a réussi, -1 sinon.
+ */
+int allouerOffres(Offres *o, int tmax) {
+    size_t mots = MOTS_POURVU(tmax) * sizeof(unsigned long long);
+    char *chaud, *froid;
+
+    chaud = (char *)calloc(mots + tmax * (sizeof(int) + 1) + 1, 1);
+    froid = (char *)calloc(tmax * (3 * sizeof(int) + sizeof(short)) + 1, 1);
+    if (chaud == NULL || froid == NULL) {
+        free(chaud);
+        free(froid);
+        return -1; // Problème d'allocation
+    }
+
+    o->tBitsPourvu = (unsigned long long *)chaud;
+    o->tRef = (int *)(chaud + mots);
+    o->tNbCandid = (unsigned char *)(o->tRef + tmax);
+    o->tEtu1 = (int *)froid;
+    o->tEtu2 = o->tEtu1 + tmax;
+    o->tEtu3 = o->tEtu2 + tmax;
+    o->tNumDpt = (short *)(o->tEtu3 + tmax);
+    o->tlog = 0;
+    o->tmax = tmax;
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Libère les colonnes d'offres allouées par allouerOffres.
+ * 
+ * \param o Offres à libérer.
+ */
+void libererOffres(Offres *o) {
+    free(o->tBitsPourvu); // Bloc chaud
+    free(o->tEtu1); // Bloc froid
+    o->tlog = 0;
+}
+
+/**
+ * \brief Alloue des colonnes d'étudiants vides (un seul bloc : NUM, REF STAGE, NOTE).
+ * 
+ * \param e Étudiants à initialiser (à libérer avec libererEtudiants).
+ * \param tmax Capacité des colonnes.
+ * \return 1 si l'allocation a réussi, -1 sinon.
+ */
+int allouerEtudiants(Etudiants *e, int tmax) {
+    int *bloc = (int *)calloc(tmax * (2 * sizeof(int) + sizeof(short)) + 1, 1);
+
+    if (bloc == NULL) return -1; // Problème d'allocation
+    e->tNumEtu = bloc;
+    e->tRefStage = bloc + tmax;
+    e->tNote = (short *)(bloc + 2 * tmax);
+    e->tlog = 0;
+    e->tmax = tmax;
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Libère les colonnes d'étudiants allouées par allouerEtudiants.
+ * 
+ * \param e Étudiants à libérer.
+ */
+void libererEtudiants(Etudiants *e) {
+    free(e->tNumEtu);
+    e->tlog = 0;
+}
+
+/**
+ * \brief Alloue les colonnes vides d'un stockage.
+ * 
+ * \param s Stockage à initialiser (à libérer avec libererStockage).
+ * \param tmaxOffre Capacité des colonnes des offres.
+ * \param tmaxEtu Capacité des colonnes des étudiants.
+ * \return 1 si l'allocation a réussi, -1 sinon.
+ */
+int creerStockage(Stockage *s, int tmaxOffre, int tmaxEtu) {
+    if (allouerOffres(&s->offres, tmaxOffre) == -1) return -1; // Problème d'allocation
+    if (allouerEtudiants(&s->etudiants, tmaxEtu) == -1) {
+        libererOffres(&s->offres);
+        return -1; // Problème d'allocation
+    }
+    attentesInit(&s->attentes);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Alloue un stockage assez grand pour les fichiers de "DATA", plus une marge pour les offres ajoutées.
+ * 
+ * Les capacités sont tirées de la taille des fichiers, comme dans chargerDossier ;
+ * en mode découpé, la taille des offres est celle de tous les fichiers de département.
+ * 
+ * \param s Stockage à initialiser (à libérer avec libererStockage).
+ * \param margeOffres Places réservées en plus pour les offres ajoutées pendant la session.
+ * \return 1 si l'allocation a réussi, -1 sinon.
+ */
+int creerStockageDonnees(Stockage *s, int margeOffres) {
+    struct stat infos;
+    FILE *flot;
+    int *tDpts;
+    long tailleOffres = 0, tailleEtudiants = 0;
+
+    flot = fopen(FICHIER_MANIFESTE, "r");
+    if (flot != NULL) { // Offres découpées par département
+        if (lireDepartementsManifeste(flot, DOSSIER_DATA, &tDpts, &tailleOffres) == -1) {
+            fclose(flot);
+            return -1;
+        }
+        fclose(flot);
+        free(tDpts);
+    }
+    else if (stat(FICHIER_OFFRES, &infos) == 0) tailleOffres = infos.st_size;
+    if (stat(FICHIER_ETUDIANTS, &infos) == 0) tailleEtudiants = infos.st_size;
+
+    // Un enregistrement occupe au moins 4 octets
+    return creerStockage(s, (int)(tailleOffres / 4 + 1) + margeOffres, (int)(tailleEtudiants / 4 + 1));
+}
+
+/**
+ * \brief Libère les colonnes d'un stockage.
+ * 
+ * \param s Stockage à libérer.
+ */
+void libererStockage(Stockage *s) {
+    libererOffres(&s->offres);
+    libererEtudiants(&s->etudiants);
+    libererAttentes(&s->attentes);
+}
+
+/**
+ * \brief Charge simultanément les offres et les étudiants dans un stockage.
+ * 
+ * \param s Stockage créé par creerStockageDonnees.
+ * \return 1 si tout s'est bien passé, 2 si des listes d'attente invalides ont été ignorées, -1 erreur sur les offres,
+ * -2 erreur sur les étudiants, -3 trop d'étudiants pour le stockage, -4 erreur sur les listes d'attente,
+ * -5 trop d'offres pour le stockage.
+ */
+int chargerStockage(Stockage *s) {
+    Chargement offres = {&s->offres, NULL, 0};
+    Chargement etudiants = {NULL, &s->etudiants, 0};
+    pthread_t filOffres;
+    int attente;
+    int fd = verrouillerDonnees(LOCK_SH); // Pas de sauvegarde d'un autre processus pendant la lecture
+
+    if (pthread_create(&filOffres, NULL, chargerOffres, &offres) != 0) chargerOffres(&offres);
+    else {
+        chargerEtudiants(&etudiants);
+        pthread_join(filOffres, NULL);
+    }
+    if (etudiants.code == 0) chargerEtudiants(&etudiants); // Pas encore chargé
+    attente = lireFichierAttente(FICHIER_ATTENTE, s, 0); // Départements découpés chargés à la demande
+    estampilleBase = lireEstampille();
+    deverrouillerDonnees(fd);
+
+    if (offres.code == -1) return -1;
+    if (offres.code == -2) return -5;
+    if (etudiants.code == -1) return -2;
+    if (etudiants.code == -2) return -3;
+    if (attente == -1) return -4;
+    if (attente == 2) return 2;
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Ajoute une offre de stage, sans candidat, à sa place dans l'ordre des références.
+ * 
+ * \param s Stockage des données.
+ * \param ref Numéro de référence du stage.
+ * \param dpt Département du stage.
+ * \return 1 si le stage a été ajouté, -1 s'il existe déjà, -2 si le tableau est plein ou si les offres
+ * du département n'ont pas pu être chargées, -3 si le département est hors limites.
+ */
+int ajouterOffre(Stockage *s, int ref, int dpt) {
+    Offres *o = &s->offres;
+    int pos, trouve;
+
+    if (dpt < DPT_MIN || dpt > DPT_MAX) return -3; // Département hors limites
+    // La référence peut exister dans un autre département, et le fichier du département sera réécrit en entier
+    if (chargerPlageRef(s, ref, ref) != 1 || chargerDepartement(s, dpt) != 1) return -2;
+    pos = rechercheDichoRef(o->tRef, o->tlog, ref, &trouve);
+    if (trouve == 1) return -1; // Stage existe déjà
+    if (o->tlog >= o->tmax) return -2; // Tableau trop petit
+
+    decalerAdroite(o, pos);
+    o->tRef[pos] = ref;
+    fixerDpt(o, pos, dpt);
+    fixerPourvu(o, pos, 0);
+    fixerCandid(o, pos, 0);
+    o->tEtu1[pos] = 0;
+    o->tEtu2[pos] = 0;
+    o->tEtu3[pos] = 0;
+    journaliserOffre(JOURNAL_AJOUT, pos, o);
+    emettreEvenement("AJOUT %d %d", ref, dpt);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Supprime une offre de stage.
+ * 
+ * \param s Stockage des données.
+ * \param ref Numéro de référence du stage.
+ * \return 1 si le stage a été supprimé, -1 s'il n'existe pas, -2 si les offres n'ont pas pu être chargées.
+ */
+int supprimerOffre(Stockage *s, int ref) {
+    Offres *o = &s->offres;
+    int pos, trouve;
+
+    if (chargerPlageRef(s, ref, ref) != 1) return -2;
+    pos = rechercheDichoRef(o->tRef, o->tlog, ref, &trouve);
+    if (trouve == 0) return -1; // Stage non trouvé
+
+    viderAttente(s, ref);
+    journaliserOffre(JOURNAL_SUPPR, pos, o);
+    retirerOffre(o, pos);
+    emettreEvenement("SUPPR %d", ref);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Enregistre la candidature d'un étudiant à une offre.
+ * 
+ * Si le stage a déjà 3 candidats, l'étudiant est mis en liste d'attente.
+ * 
+ * \param s Stockage des données.
+ * \param ref Numéro de référence du stage.
+ * \param etu Numéro de l'étudiant.
+ * \return 1 si la candidature est enregistrée, 2 si l'étudiant est mis en attente, -3 si le stage est pourvu,
+ * -4 si l'étudiant est déjà candidat ou en attente, -6 si le stage n'existe pas, -7 en cas d'erreur d'allocation
+ * ou de chargement.
+ */
+int candidaterOffre(Stockage *s, int ref, int etu) {
+    Offres *o = &s->offres;
+    int i, trouve;
+
+    if (chargerPlageRef(s, ref, ref) != 1) return -7;
+    i = rechercheDichoRef(o->tRef, o->tlog, ref, &trouve);
+    if (trouve == 0) return -6;
+
+    if (pourvuOffre(o, i) == 1) return -3;
+    if (o->tEtu1[i] == etu || o->tEtu2[i] == etu || o->tEtu3[i] == etu) return -4;
+    if (candidOffre(o, i) >= 3) return mettreEnAttente(s, ref, etu);
+
+    journaliserOffre(JOURNAL_MODIF, i, o);
+    if (o->tEtu1[i] == 0) {
+        o->tEtu1[i] = etu;
+    } else if (o->tEtu2[i] == 0) {
+        o->tEtu2[i] = etu;
+    } else if (o->tEtu3[i] == 0) {
+        o->tEtu3[i] = etu;
+    }
+    fixerCandid(o, i, candidOffre(o, i) + 1);
+    emettreEvenement("CANDID %d %d", ref, etu);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Affecte un stage à un étudiant et retire l'étudiant des autres offres où il était candidat.
+ * 
+ * \param s Stockage des données.
+ * \param ref Numéro de référence du stage.
+ * \param etu Numéro de l'étudiant.
+ * \return 1 si l'affectation a réussi, -2 si le stage n'existe pas, -3 si les offres n'ont pas pu être chargées.
+ */
+int affecterOffre(Stockage *s, int ref, int etu) {
+    Offres *o = &s->offres;
+    Etudiants *e = &s->etudiants;
+    int pos, trouve;
+
+    if (chargerToutesOffres(s) != 1) return -3; // L'étudiant peut être candidat dans tous les départements
+    pos = rechercheDichoRef(o->tRef, o->tlog, ref, &trouve);
+    if (trouve == 0) return -2; // Stage non trouvé
+
+    oublierAttentes(s, etu);
+    for (int i = 0; i < o->tlog; i++) {
+        if (o->tRef[i] != ref) {
+            if (o->tEtu1[i] == etu || o->tEtu2[i] == etu || o->tEtu3[i] == etu) {
+                journaliserOffre(JOURNAL_MODIF, i, o);
+            }
+            if (o->tEtu1[i] == etu) {
+                o->tEtu1[i] = o->tEtu2[i];
+                o->tEtu2[i] = o->tEtu3[i];
+                o->tEtu3[i] = 0;
+                fixerCandid(o, i, candidOffre(o, i) - 1);
+            }
+            else if (o->tEtu2[i] == etu) {
+                o->tEtu2[i] = o->tEtu3[i];
+                o->tEtu3[i] = 0;
+                fixerCandid(o, i, candidOffre(o, i) - 1);
+            }
+            else if (o->tEtu3[i] == etu) {
+                o->tEtu3[i] = 0;
+                fixerCandid(o, i, candidOffre(o, i) - 1);
+            }
+            promouvoirAttente(s, i); // Place libérée : la tête de file la prend
+        }
+    }
+
+    for (int j = 0; j < e->tlog; j++) {
+        if (e->tNumEtu[j] == etu) {
+            journaliserEtudiant(JOURNAL_STAGE, j, e->tRefStage[j], noteEtudiant(e, j));
+            e->tRefStage[j] = ref;
+            break;
+        }
+    }
+
+    journaliserOffre(JOURNAL_MODIF, pos, o);
+    fixerPourvu(o, pos, 1);
+    fixerCandid(o, pos, 0);
+    o->tEtu1[pos] = 0;
+    o->tEtu2[pos] = 0;
+    o->tEtu3[pos] = 0;
+    viderAttente(s, ref);
+    emettreEvenement("AFFECT %d %d", ref, etu);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Enregistre la moyenne finale d'un étudiant.
+ * 
+ * \param s Stockage des données.
+ * \param num Numéro de l'étudiant.
+ * \param moyenne Moyenne finale.
+ * \return 1 si la note est enregistrée, -1 si l'étudiant n'existe pas, -2 si la note est hors limites.
+ */
+int noterEtudiant(Stockage *s, int num, float moyenne) {
+    Etudiants *e = &s->etudiants;
+    int place = rechercherEtudiant(e->tNumEtu, e->tlog, num);
+
+    if (place == -1) return -1; // Etudiant non trouvé
+    if (noteRepresentable(moyenne) == 0) return -2; // Note hors limites
+    journaliserEtudiant(JOURNAL_NOTE, place, 0, noteEtudiant(e, place));
+    fixerNote(e, place, moyenne);
+    emettreEvenement("NOTE %d %.2f", num, moyenne);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Écrit une offre de stage dans un fichier au format de "offrestage.don".
+ * 
+ * \param flot Fichier ouvert en écriture.
+ * \param o Offres de stage.
+ * \param i Position de l'offre.
+ */
+void ecrireOffre(FILE *flot, Offres *o, int i) {
+    int pourvu = pourvuOffre(o, i), candid = candidOffre(o, i);
+
+    fprintf(flot, "\n%d %d\n%d\n%d", o->tRef[i], dptOffre(o, i), pourvu, candid);
+    if (pourvu == 0) {
+        if (candid == 3) fprintf(flot, "\n%d\n%d\n%d", o->tEtu1[i], o->tEtu2[i], o->tEtu3[i]);
+        else if (candid == 2) fprintf(flot, "\n%d\n%d", o->tEtu1[i], o->tEtu2[i]);
+        else if (candid == 1) fprintf(flot, "\n%d", o->tEtu1[i]);
+    }
+}
+
+/**
+ * \brief Ouvre le fichier temporaire "<chemin>.tmp" dans lequel préparer un fichier de données.
+ * 
+ * \param chemin Chemin du fichier de données.
+ * \return Le fichier temporaire ouvert en écriture, NULL en cas d'erreur.
+ */
+FILE *ouvrirTemporaire(const char *chemin) {
+    char tmp[128];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", chemin);
+    return fopen(tmp, "w");
+}
+
+/**
+ * \brief Remplace atomiquement un fichier de données par son fichier temporaire.
+ * 
+ * Le contenu est forcé sur le disque (fsync) avant le renommage : en cas d'arrêt
+ * brutal, le fichier contient soit l'ancienne version, soit la nouvelle.
+ * 
+ * \param flot Fichier temporaire ouvert par ouvrirTemporaire (fermé par la fonction).
+ * \param chemin Chemin du fichier de données.
+ * \param valider 1 pour publier le fichier, 0 pour l'abandonner.
+ * \return 1 si le fichier a été publié, -1 sinon.
+ */
+int publierTemporaire(FILE *flot, const char *chemin, int valider) {
+    char tmp[128];
+    int code = 1;
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", chemin);
+    if (fflush(flot) != 0 || fsync(fileno(flot)) != 0) code = -1;
+    if (fclose(flot) != 0) code = -1;
+    if (valider == 0) code = -1;
+
+    if (code == 1 && rename(tmp, chemin) != 0) code = -1;
+    if (code == -1) remove(tmp);
+    return code;
+}
+
+/**
+ * \brief Force sur le disque le contenu d'un dossier (les renommages qui y ont eu lieu).
+ * 
+ * \param dossier Chemin du dossier.
+ */
+void synchroniserDossier(const char *dossier) {
+    int fd = open(dossier, O_RDONLY);
+    if (fd == -1) return;
+    fsync(fd);
+    close(fd);
+}
+
+/**
+ * \brief Écrit les fichiers des offres et des étudiants correspondant à une version des données.
+ * 
+ * \param o Offres de stage.
+ * \param e Étudiants.
+ * \param tAttente[] Listes d'attente mises à plat (voir aplatirAttentes).
+ * \param lgAttente Longueur du tableau des listes d'attente.
+ * \param complet 1 si les offres sont celles de tous les départements (voir ecrireShards), 0 sinon.
+ * \param versionEcrite Version des données écrites.
+ * \return 1 si la sauvegarde s'est bien effectuée, -1 en cas d'erreur.
+ */
+int ecrireFichiers(Offres *o, Etudiants *e, int tAttente[], int lgAttente, int complet, int versionEcrite) {
+    FILE *flot;
+    int ok = 1;
+
+    if (modeShards == 1) {
+        if (ecrireShards(o, 0, complet, versionEcrite) == -1) return -1;
+    }
+    else {
+        flot = ouvrirTemporaire(FICHIER_OFFRES);
+        if (flot == NULL) return -1;
+
+        for (int i = 0; i < o->tlog; i++) {
+            ecrireOffre(flot, o, i);
+        }
+        if (ferror(flot)) ok = 0;
+
+        if (publierTemporaire(flot, FICHIER_OFFRES, ok) == -1) return -1;
+    }
+    
+    flot = ouvrirTemporaire(FICHIER_ETUDIANTS);
+    if (flot == NULL) return -1; // Problème ouverture fichier
+
+    for (int i = 0; i < e->tlog; i++) {
+        fprintf(flot, "%d %d %.2f\n", e->tNumEtu[i], e->tRefStage[i], noteEtudiant(e, i));
+    }
+    if (ferror(flot)) ok = 0;
+
+    if (publierTemporaire(flot, FICHIER_ETUDIANTS, ok) == -1) return -1;
+    if (ecrireFichierAttente(tAttente, lgAttente) == -1) return -1;
+    synchroniserDossier(DOSSIER_DATA);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Sauvegarde les modifications apportées aux stages et aux étudiants dans un fichier.
+ * 
+ * En mode découpé par département, seuls les fichiers des départements modifiés
+ * depuis la dernière sauvegarde sont réécrits.
+ * 
+ * \param s Stockage des données.
+ * \return 1 si la sauvegarde s'est bien effectuée, -1 en cas d'erreur.
+ */
+int modificationFichier(Stockage *s) {
+    int *tAttente, lgAttente, code;
+
+    if (aplatirAttentes(&s->attentes, &tAttente, &lgAttente) == -1) return -1;
+    code = sauvegarderDonnees(&s->offres, &s->etudiants, tAttente, lgAttente, versionDonnees());
+    free(tAttente);
+    return code;
+}
+
+
+/**
+ * \brief Prend le verrou consultatif partagé par tous les processus qui utilisent DATA.
+ * 
+ * \param mode LOCK_SH pour lire les fichiers, LOCK_EX pour les écrire.
+ * \return Le descripteur à rendre avec deverrouillerDonnees, -1 si le verrou est indisponible.
+ */
+int verrouillerDonnees(int mode) {
+    int fd = open(FICHIER_VERROU, O_RDWR | O_CREAT, 0644);
+
+    if (fd == -1) return -1; // Dossier en lecture seule : pas de verrou
+    if (flock(fd, mode) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * \brief Rend le verrou consultatif.
+ * 
+ * \param fd Descripteur donné par verrouillerDonnees (-1 : rien à rendre).
+ */
+void deverrouillerDonnees(int fd) {
+    if (fd == -1) return;
+    flock(fd, LOCK_UN);
+    close(fd);
+}
+
+/**
+ * \brief Lit l'estampille des fichiers de données.
+ * 
+ * \return L'estampille, 0 si le fichier n'existe pas encore.
+ */
+int lireEstampille(void) {
+    FILE *flot;
+    int estampille = 0;
+
+    flot = fopen(FICHIER_ESTAMPILLE, "r");
+    if (flot == NULL) return 0;
+    if (fscanf(flot, "%d", &estampille) != 1) estampille = 0;
+    fclose(flot);
+    return estampille;
+}
+
+/**
+ * \brief Écrit l'estampille des fichiers de données.
+ * 
+ * \param estampille Nouvelle estampille.
+ * \return 1 si l'estampille a été écrite, -1 en cas d'erreur.
+ */
+int ecrireEstampille(int estampille) {
+    FILE *flot;
+
+    flot = ouvrirTemporaire(FICHIER_ESTAMPILLE);
+    if (flot == NULL) return -1;
+    fprintf(flot, "%d\n", estampille);
+    return publierTemporaire(flot, FICHIER_ESTAMPILLE, !ferror(flot));
+}
+
+/**
+ * \brief Note qu'une ligne a été modifiée par la session, avec son image avant modification.
+ * 
+ * \param offre 1 pour une offre, 0 pour un étudiant.
+ * \param cle REF de l'offre, ou position de l'étudiant.
+ * \param champ Nature de la modification (MODIF_...).
+ * \param tAvant[] Ligne de l'offre avant modification, ou REF STAGE de l'étudiant en première case (NULL : sans objet).
+ * \param noteAvant Note de l'étudiant avant modification.
+ */
+void noterModification(int offre, int cle, int champ, int tAvant[], float noteAvant) {
+    Modification *nouveau;
+    int v = versionDonnees();
+
+    pthread_mutex_lock(&verrouModifs);
+    if (tlogModifs == tmaxModifs) {
+        int tmax = tmaxModifs == 0 ? 64 : tmaxModifs * 2;
+        nouveau = (Modification *)realloc(tModifs, tmax * sizeof(Modification));
+        if (nouveau == NULL) {
+            modifsIncompletes = 1;
+            pthread_mutex_unlock(&verrouModifs);
+            return; // Problème d'allocation
+        }
+        tModifs = nouveau;
+        tmaxModifs = tmax;
+    }
+    tModifs[tlogModifs].offre = offre;
+    tModifs[tlogModifs].cle = cle;
+    tModifs[tlogModifs].version = v;
+    tModifs[tlogModifs].champ = champ;
+    for (int i = 0; i < 7; i++) tModifs[tlogModifs].tAvant[i] = tAvant == NULL ? 0 : tAvant[i];
+    tModifs[tlogModifs].noteAvant = noteAvant;
+    tlogModifs++;
+    pthread_mutex_unlock(&verrouModifs);
+}
+
+/**
+ * \brief Compare deux modifications (offres puis étudiants, par clé, puis dans l'ordre où elles ont été faites) pour qsort.
+ * 
+ * \param a Première modification.
+ * \param b Seconde modification.
+ * \return Négatif, nul ou positif selon l'ordre des modifications.
+ */
+int comparerModifications(const void *a, const void *b) {
+    const Modification *x = (const Modification *)a, *y = (const Modification *)b;
+    if (x->offre != y->offre) return y->offre - x->offre;
+    if (x->cle != y->cle) return (x->cle > y->cle) - (x->cle < y->cle);
+    return (x->version > y->version) - (x->version < y->version);
+}
+
+/**
+ * \brief Charge la version des fichiers présente sur le disque, sans toucher aux données du programme.
+ * 
+ * \param d Stockage à créer (à libérer avec libererStockage si le chargement a réussi).
+ * \param margeOffres Places réservées en plus pour des offres ajoutées après le chargement.
+ * \return 1 si tout s'est bien passé, -1 en cas d'erreur.
+ */
+int chargerDisque(Stockage *d, int margeOffres) {
+    // Découpé ou non, selon ce qui est sur le disque (un autre processus a pu ajouter des départements)
+    return chargerDossier(d, DOSSIER_DATA, margeOffres) == 1 ? 1 : -1;
+}
+
+/**
+ * \brief Indique si un étudiant figure parmi des candidats.
+ * 
+ * \param t[] Candidats (0 : place libre).
+ * \param nb Nombre de places.
+ * \param etu Numéro de l'étudiant.
+ * \return 1 si l'étudiant est candidat, 0 sinon.
+ */
+int contientCandidat(int t[], int nb, int etu) {
+    for (int i = 0; i < nb; i++) {
+        if (t[i] == etu) return 1;
+    }
+    return 0;
+}
+
+/**
+ * \brief Reporte sur la version des fichiers les changements faits par la session sur une offre.
+ * 
+ * Si la ligne des fichiers est encore celle d'avant la modification, la ligne de
+ * la session est recopiée. Sinon, un autre processus l'a changée aussi : seuls les
+ * changements de la session sont appliqués (candidats ajoutés ou retirés, offre
+ * pourvue), et la fusion est refusée quand ils contredisent ceux de l'autre processus.
+ * 
+ * \param o Offres des fichiers (modifiées).
+ * \param base Première modification de l'offre, avec la ligne d'avant la modification.
+ * \param session Offres de la session.
+ * \return 1 si l'offre a été reportée, -1 si le tableau est plein, -2 en cas de conflit.
+ */
+int fusionnerOffre(Offres *o, Modification *base, Offres *session) {
+    int ref = base->cle, *tAvant = base->tAvant, ps, pd, ts, td, nb = 0;
+    int tSession[3], tDisque[3], tFusion[3] = {0, 0, 0}, tLigneS[7], tLigneD[7];
+
+    ps = rechercheDichoRef(session->tRef, session->tlog, ref, &ts);
+    pd = rechercheDichoRef(o->tRef, o->tlog, ref, &td);
+    if (ts == 1) lireLigneOffre(session, ps, tLigneS);
+    if (td == 1) lireLigneOffre(o, pd, tLigneD);
+
+    if (base->champ == MODIF_ABSENTE) { // Offre ajoutée par la session
+        if (ts == 0) return 1; // Retirée depuis par la session
+        if (td == 1) { // Même référence ajoutée par un autre processus
+            if (memcmp(tLigneD + 1, tLigneS + 1, 6 * sizeof(int)) != 0) return -2;
+            return 1;
+        }
+        if (o->tlog >= o->tmax) return -1; // Tableau trop petit
+        decalerAdroite(o, pd);
+    }
+    else if (td == 0) return ts == 0 ? 1 : -2; // Supprimée par un autre processus : conflit si la session l'a gardée
+    else if (memcmp(tLigneD + 1, tAvant + 1, 6 * sizeof(int)) != 0) {
+        // Ligne changée aussi par un autre processus : report champ par champ
+        if (ts == 0) return -2; // Supprimée par la session, modifiée ailleurs
+        if (tLigneS[2] != tAvant[2]) {
+            if (tLigneD[2] != tAvant[2] && tLigneD[2] != tLigneS[2]) return -2;
+            fixerPourvu(o, pd, tLigneS[2]);
+        }
+        if (tLigneS[2] == 1 && tAvant[2] == 0) { // Pourvue par la session : plus de candidats
+            fixerCandid(o, pd, 0);
+            o->tEtu1[pd] = 0;
+            o->tEtu2[pd] = 0;
+            o->tEtu3[pd] = 0;
+            return 1;
+        }
+
+        tSession[0] = session->tEtu1[ps];
+        tSession[1] = session->tEtu2[ps];
+        tSession[2] = session->tEtu3[ps];
+        tDisque[0] = o->tEtu1[pd];
+        tDisque[1] = o->tEtu2[pd];
+        tDisque[2] = o->tEtu3[pd];
+        for (int i = 0; i < 3; i++) { // Candidats des fichiers, moins ceux retirés par la session
+            if (tDisque[i] == 0) continue;
+            if (contientCandidat(tAvant + 4, 3, tDisque[i]) == 1 && contientCandidat(tSession, 3, tDisque[i]) == 0) continue;
+            tFusion[nb++] = tDisque[i];
+        }
+        for (int i = 0; i < 3; i++) { // Plus ceux ajoutés par la session
+            if (tSession[i] == 0 || contientCandidat(tAvant + 4, 3, tSession[i]) == 1 || contientCandidat(tFusion, nb, tSession[i]) == 1) continue;
+            if (nb == 3 || pourvuOffre(o, pd) == 1) return -2; // Plus de place, ou pourvue par un autre processus
+            tFusion[nb++] = tSession[i];
+        }
+        fixerCandid(o, pd, nb);
+        o->tEtu1[pd] = tFusion[0];
+        o->tEtu2[pd] = tFusion[1];
+        o->tEtu3[pd] = tFusion[2];
+        return 1;
+    }
+    else if (ts == 0) { // Supprimée par la session, intacte ailleurs
+        retirerOffre(o, pd);
+        return 1;
+    }
+
+    ecrireLigneOffre(o, pd, tLigneS);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Reporte sur la version des fichiers le stage et la note changés par la session pour un étudiant.
+ * 
+ * Un champ changé aussi par un autre processus, avec une autre valeur, est un conflit.
+ * 
+ * \param e Étudiants des fichiers (modifiés).
+ * \param index Index des étudiants des fichiers.
+ * \param tGroupe[] Modifications de l'étudiant, dans l'ordre où elles ont été faites.
+ * \param nb Nombre de modifications.
+ * \param session Étudiants de la session.
+ * \return 1 si l'étudiant a été reporté, -2 en cas de conflit.
+ */
+int fusionnerEtudiant(Etudiants *e, IndexEtudiants *index, Modification tGroupe[], int nb, Etudiants *session) {
+    Modification *baseStage = NULL, *baseNote = NULL;
+    int pos = tGroupe[0].cle, j;
+
+    if (pos >= session->tlog) return 1;
+    j = indiceEtudiant(index, session->tNumEtu[pos]);
+    if (j == -1) return 1; // Étudiant absent des fichiers
+
+    for (int m = 0; m < nb; m++) { // Valeur d'avant la première modification de chaque champ
+        if (tGroupe[m].champ == MODIF_STAGE && baseStage == NULL) baseStage = &tGroupe[m];
+        if (tGroupe[m].champ == MODIF_NOTE && baseNote == NULL) baseNote = &tGroupe[m];
+    }
+    if (baseStage != NULL && session->tRefStage[pos] != baseStage->tAvant[0]) {
+        if (e->tRefStage[j] != baseStage->tAvant[0] && e->tRefStage[j] != session->tRefStage[pos]) return -2;
+        e->tRefStage[j] = session->tRefStage[pos];
+    }
+    if (baseNote != NULL && noteEtudiant(session, pos) != baseNote->noteAvant) {
+        if (noteEtudiant(e, j) != baseNote->noteAvant && noteEtudiant(e, j) != noteEtudiant(session, pos)) return -2;
+        fixerNote(e, j, noteEtudiant(session, pos));
+    }
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Rejoue sur la liste d'attente des fichiers les ajouts et retraits faits par la session pour une offre.
+ * 
+ * Les étudiants mis en attente par un autre processus restent dans la file. Si
+ * l'offre des fichiers a des places libres, les premiers de la file les prennent ;
+ * si elle n'existe plus ou est pourvue, la file des fichiers est vidée quand la
+ * session n'y attend plus personne, et la fusion est refusée sinon.
+ * 
+ * \param d Version des fichiers, offres déjà fusionnées (modifiée).
+ * \param session Listes d'attente de la session.
+ * \param tGroupe[] Modifications de l'offre, dans l'ordre où elles ont été faites.
+ * \param nb Nombre de modifications.
+ * \return 1 si la file a été reportée, -1 en cas d'erreur d'allocation, -2 en cas de conflit.
+ */
+int fusionnerAttente(Stockage *d, Attentes *session, Modification tGroupe[], int nb) {
+    Offres *o = &d->offres;
+    int ref = tGroupe[0].cle, etu, rang, f, pos, trouve;
+
+    pos = rechercheDichoRef(o->tRef, o->tlog, ref, &trouve);
+    for (int m = 0; m < nb; m++) {
+        etu = tGroupe[m].tAvant[1];
+        rang = rangAttente(&d->attentes, ref, etu);
+        if (tGroupe[m].champ == MODIF_ATTENTE_AJOUT && rang == -1) {
+            if (trouve == 1 && (o->tEtu1[pos] == etu || o->tEtu2[pos] == etu || o->tEtu3[pos] == etu)) continue; // Déjà candidat
+            if (insererAttente(&d->attentes, ref, etu, -1) == -1) return -1; // Après ceux déjà en attente dans les fichiers
+        }
+        else if (tGroupe[m].champ == MODIF_ATTENTE_RETRAIT && rang != -1) retirerAttente(&d->attentes, ref, rang);
+    }
+
+    f = fileAttente(&d->attentes, ref, 0);
+    if (f == -1 || d->attentes.tNb[f] == 0) return 1;
+    switch (violationFile(o, ref, 1)) {
+        case VIOLATION_ATTENTE_PLACE: // Place libérée par un autre processus : la tête de file la prend
+            while (candidOffre(o, pos) < 3 && d->attentes.tNb[f] > 0) {
+                etu = retirerAttente(&d->attentes, ref, 0);
+                if (o->tEtu1[pos] == 0) o->tEtu1[pos] = etu;
+                else if (o->tEtu2[pos] == 0) o->tEtu2[pos] = etu;
+                else o->tEtu3[pos] = etu;
+                fixerCandid(o, pos, candidOffre(o, pos) + 1);
+            }
+            break;
+
+        case VIOLATION_ATTENTE_OFFRE: // Offre supprimée ou pourvue
+            if (listeAttente(session, ref, &etu, 1) > 0) return -2; // La session y attend encore : conflit
+            while (retirerAttente(&d->attentes, ref, 0) != 0);
+            break;
+    }
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Reporte les lignes modifiées par la session sur la version des fichiers.
+ * 
+ * Seuls les changements faits par la session sont reportés (voir fusionnerOffre,
+ * fusionnerEtudiant et fusionnerAttente). Les autres lignes gardent la version des fichiers.
+ * 
+ * \param d Version des fichiers (modifiée).
+ * \param tModifs[] Lignes modifiées (triées par la fonction).
+ * \param nb Nombre de lignes modifiées.
+ * \param o Offres de la session.
+ * \param e Étudiants de la session.
+ * \param tAttente[] Listes d'attente de la session mises à plat (voir aplatirAttentes).
+ * \param lgAttente Longueur du tableau des listes d'attente.
+ * \return 1 si les lignes ont été reportées, -1 en cas d'erreur d'allocation ou si le tableau est plein,
+ * -2 si une ligne a été changée autrement par un autre processus.
+ */
+int fusionnerModifications(Stockage *d, Modification tModifs[], int nb, Offres *o, Etudiants *e, int tAttente[], int lgAttente) {
+    IndexEtudiants index;
+    Attentes session;
+    Modification *base;
+    int fin, code = 1;
+
+    if (indexerEtudiants(&index, d->etudiants.tNumEtu, d->etudiants.tlog) == -1) return -1;
+    attentesInit(&session);
+    if (chargerAttentesTableau(&session, tAttente, lgAttente) == -1) code = -1;
+    qsort(tModifs, nb, sizeof(Modification), comparerModifications);
+
+    for (int k = 0; k < nb && code == 1; k = fin) {
+        // Modifications de la même ligne : de k à fin exclu
+        for (fin = k + 1; fin < nb && tModifs[fin].offre == tModifs[k].offre && tModifs[fin].cle == tModifs[k].cle; fin++);
+
+        if (tModifs[k].offre == 0) {
+            code = fusionnerEtudiant(&d->etudiants, &index, tModifs + k, fin - k, e);
+            continue;
+        }
+
+        base = NULL;
+        for (int m = k; m < fin && base == NULL; m++) {
+            if (tModifs[m].champ == MODIF_LIGNE || tModifs[m].champ == MODIF_ABSENTE) base = &tModifs[m];
+        }
+        if (base != NULL) code = fusionnerOffre(&d->offres, base, o);
+        if (code == 1) code = fusionnerAttente(d, &session, tModifs + k, fin - k);
+    }
+    libererIndex(&index);
+    libererAttentes(&session);
+    return code;
+}
+
+/**
+ * \brief Sauvegarde une version des données sans écraser celles d'un autre processus.
+ * 
+ * Sous le verrou exclusif, l'estampille des fichiers est comparée à celle d'où
+ * viennent les données de la session. Si personne n'a sauvegardé entre-temps, les
+ * données sont écrites telles quelles ; sinon la version des fichiers est relue
+ * et seules les lignes modifiées par la session y sont reportées avant l'écriture.
+ * La sauvegarde est refusée, sans rien écrire, si une ligne a été changée autrement
+ * par l'autre processus, ou si une modification de la session n'a pas pu être notée.
+ * L'estampille est augmentée avant les fichiers : une sauvegarde interrompue se
+ * traduit au pire par une fusion inutile.
+ * 
+ * \param o Offres de stage.
+ * \param e Étudiants.
+ * \param tAttente[] Listes d'attente mises à plat (voir aplatirAttentes).
+ * \param lgAttente Longueur du tableau des listes d'attente.
+ * \param versionEcrite Version des données écrites.
+ * \return 1 si la sauvegarde s'est bien effectuée, -1 en cas d'erreur, -2 en cas de conflit avec la
+ * sauvegarde d'un autre processus, -3 si le verrou des fichiers n'a pas pu être pris.
+ */
+int sauvegarderDonnees(Offres *o, Etudiants *e, int tAttente[], int lgAttente, int versionEcrite) {
+    Stockage d;
+    Modification *tCopie = NULL;
+    int fd, estampille, fusion, nb = 0, k = 0, code = 1, *tFusion = NULL, lgFusion = 0;
+
+    pthread_mutex_lock(&verrouDisque);
+    fd = verrouillerDonnees(LOCK_EX);
+    if (fd == -1) { // Sans verrou, un autre processus pourrait écrire en même temps
+        pthread_mutex_unlock(&verrouDisque);
+        return -3;
+    }
+    estampille = lireEstampille();
+
+    // Modifications contenues dans la version écrite ; sans elles toutes, fusion impossible
+    pthread_mutex_lock(&verrouModifs);
+    fusion = estampille != estampilleBase || memoireAJour == 0;
+    if (fusion == 1 && modifsIncompletes == 1) code = -2; // Les fichiers écraseraient des lignes inconnues de la session
+    else if (fusion == 1) {
+        tCopie = (Modification *)malloc((tlogModifs + 1) * sizeof(Modification));
+        if (tCopie == NULL) code = -1;
+        for (int i = 0; i < tlogModifs && tCopie != NULL; i++) {
+            if (tModifs[i].version <= versionEcrite) tCopie[nb++] = tModifs[i];
+        }
+    }
+    pthread_mutex_unlock(&verrouModifs);
+
+    if (fusion == 1 && code == 1) {
+        code = chargerDisque(&d, nb);
+        if (code == 1) {
+            code = fusionnerModifications(&d, tCopie, nb, o, e, tAttente, lgAttente);
+            if (code == 1) code = aplatirAttentes(&d.attentes, &tFusion, &lgFusion);
+            if (code == 1) code = ecrireEstampille(estampille + 1);
+            if (code == 1) code = ecrireFichiers(&d.offres, &d.etudiants, tFusion, lgFusion, 1, versionEcrite);
+            free(tFusion);
+            libererStockage(&d);
+        }
+    }
+    else if (code == 1) {
+        code = ecrireEstampille(estampille + 1);
+        if (code == 1) code = ecrireFichiers(o, e, tAttente, lgAttente, 0, versionEcrite);
+    }
+
+    if (code == 1) {
+        estampilleBase = estampille + 1;
+        memoireAJour = fusion == 0; // Après une fusion, les fichiers ont des lignes inconnues de la session
+
+        // Les lignes écrites n'ont plus à être reportées
+        pthread_mutex_lock(&verrouModifs);
+        for (int i = 0; i < tlogModifs; i++) {
+            if (tModifs[i].version > versionEcrite) tModifs[k++] = tModifs[i];
+        }
+        tlogModifs = k;
+        if (fusion == 0) modifsIncompletes = 0; // Tout a été écrit
+        pthread_mutex_unlock(&verrouModifs);
+    }
+    deverrouillerDonnees(fd);
+    pthread_mutex_unlock(&verrouDisque);
+    free(tCopie);
+    return code;
+}
+
+
+/**
+ * \brief Lit une ligne du manifeste : "DPT NB REFMIN REFMAX", ou "DPT" seul (ancien format).
+ * 
+ * \param flot Manifeste ouvert en lecture.
+ * \param sh Département lu (dpt, nb, refMin, refMax).
+ * \return 1 si un département a été lu, 0 à la fin du fichier.
+ */
+int lireLigneManifeste(FILE *flot, Shard *sh) {
+    char ligne[128];
+
+    while (fgets(ligne, sizeof(ligne), flot) != NULL) {
+        if (sscanf(ligne, "%d%d%d%d", &sh->dpt, &sh->nb, &sh->refMin, &sh->refMax) == 4) return 1;
+        if (sscanf(ligne, "%d", &sh->dpt) == 1) { // Intervalle inconnu : le département peut tout contenir
+            sh->nb = -1;
+            sh->refMin = INT_MIN;
+            sh->refMax = INT_MAX;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief Lit la liste des départements dans le manifeste des fichiers découpés.
+ * 
+ * Aucune offre n'est lue : les départements sont chargés à la demande.
+ * 
+ * \return 1 si le manifeste a été lu (mode découpé), 0 s'il n'existe pas, -1 en cas d'erreur d'allocation.
+ */
+int lireManifeste(void) {
+    FILE *flot;
+    Shard sh;
+    int pos;
+
+    tlogShards = 0;
+    modeShards = 0;
+    flot = fopen(FICHIER_MANIFESTE, "r");
+    if (flot == NULL) return 0; // Pas de découpage
+
+    while (lireLigneManifeste(flot, &sh) == 1) {
+        pos = ajouterShard(sh.dpt, 0);
+        if (pos == -1) {
+            fclose(flot);
+            return -1;
+        }
+        tShards[pos].nb = sh.nb;
+        tShards[pos].refMin = sh.refMin;
+        tShards[pos].refMax = sh.refMax;
+    }
+    fclose(flot);
+
+    for (int i = 0; i < tlogShards; i++) { // Fichiers déjà à jour, pas encore chargés
+        tShards[i].modifie = 0;
+        tShards[i].sauve = 0;
+        tShards[i].charge = 0;
+    }
+    manifesteModifie = 0;
+    modeShards = 1;
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Recherche un département dans la liste des fichiers découpés, et l'y ajoute s'il n'y est pas.
+ * 
+ * Un département créé par la session est considéré comme modifié : son fichier et le manifeste
+ * seront écrits. Un département découvert dans les fichiers (manifeste, fusion avec la version
+ * d'un autre processus) est déjà écrit et reste à charger.
+ * À appeler en tenant verrouShards dès que la sauvegarde automatique est démarrée.
+ * 
+ * \param dpt Numéro du département.
+ * \param charge 1 si le département est créé par la session (toutes ses offres sont en mémoire), 0 s'il vient des fichiers.
+ * \return La position du département dans la liste, -1 en cas d'erreur d'allocation.
+ */
+int ajouterShard(int dpt, int charge) {
+    Shard *nouveau;
+
+    for (int i = 0; i < tlogShards; i++) {
+        if (tShards[i].dpt == dpt) return i;
+    }
+
+    if (tlogShards == tmaxShards) {
+        int tmax = tmaxShards == 0 ? 16 : tmaxShards * 2;
+        nouveau = (Shard *)realloc(tShards, tmax * sizeof(Shard));
+        if (nouveau == NULL) return -1; // Problème d'allocation
+        tShards = nouveau;
+        tmaxShards = tmax;
+    }
+    tShards[tlogShards].dpt = dpt;
+    tShards[tlogShards].modifie = versionDonnees();
+    tShards[tlogShards].sauve = charge == 1 ? -1 : tShards[tlogShards].modifie; // Fichier d'un autre processus : déjà à jour
+    tShards[tlogShards].charge = charge;
+    tShards[tlogShards].nb = 0;
+    tShards[tlogShards].refMin = INT_MAX;
+    tShards[tlogShards].refMax = INT_MIN;
+    manifesteModifie = 1;
+    return tlogShards++;
+}
+
+/**
+ * \brief Note que le fichier d'un département doit être réécrit à la prochaine sauvegarde.
+ * 
+ * \param dpt Numéro du département modifié.
+ */
+void marquerShardModifie(int dpt) {
+    int pos;
+
+    if (modeShards == 0) return;
+    pthread_mutex_lock(&verrouShards);
+    pos = ajouterShard(dpt, 1); // Seul ajouterOffre modifie un département inconnu
+    if (pos != -1) tShards[pos].modifie = versionDonnees();
+    pthread_mutex_unlock(&verrouShards);
+}
+
+/**
+ * \brief Écrit les fichiers découpés par département et le manifeste.
+ * 
+ * Les offres sont parcourues une seule fois ; chaque offre d'un département à
+ * réécrire est envoyée dans le fichier de son département. Un département modifié
+ * après la version écrite reste à réécrire.
+ * 
+ * \param o Offres de stage.
+ * \param tous 1 pour réécrire tous les départements, 0 pour seulement ceux modifiés.
+ * \param complet 1 si les offres données sont celles de tous les départements (version des fichiers
+ * fusionnée) : les départements inconnus de la session y sont relevés sans être chargés, et l'intervalle
+ * de chaque département est recalculé ; 0 si ce sont les offres de la session.
+ * \param versionEcrite Version des données écrites.
+ * \return Le nombre de fichiers de département écrits, -1 en cas d'erreur.
+ */
+int ecrireShards(Offres *o, int tous, int complet, int versionEcrite) {
+    FILE *flot, **tFlots;
+    char chemin[64];
+    Shard *tInfos;
+    int *tDpts, nbShards, manifeste, pos, nb = 0, ok = 1;
+
+    // Liste des fichiers à écrire, relevée sous verrou
+    pthread_mutex_lock(&verrouShards);
+    for (int i = 0; i < o->tlog; i++) { // Tout département présent doit avoir son fichier
+        if (ajouterShard(dptOffre(o, i), complet == 0) == -1) {
+            pthread_mutex_unlock(&verrouShards);
+            return -1;
+        }
+    }
+    nbShards = tlogShards;
+    tFlots = (FILE **)calloc(nbShards + 1, sizeof(FILE *));
+    tDpts = (int *)malloc((nbShards + 1) * sizeof(int));
+    tInfos = (Shard *)malloc((nbShards + 1) * sizeof(Shard));
+    if (tFlots == NULL || tDpts == NULL || tInfos == NULL) {
+        pthread_mutex_unlock(&verrouShards);
+        free(tFlots);
+        free(tDpts);
+        free(tInfos);
+        return -1; // Problème d'allocation
+    }
+    for (int i = 0; i < nbShards; i++) {
+        tDpts[i] = tShards[i].dpt;
+        tInfos[i] = tShards[i];
+        tFlots[i] = (FILE *)(tous == 1 || tShards[i].modifie > tShards[i].sauve ? (FILE *)1 : NULL); // À écrire
+    }
+    manifeste = manifesteModifie == 1 || tous == 1;
+    manifesteModifie = 0;
+    pthread_mutex_unlock(&verrouShards);
+
+    mkdir(DOSSIER_SHARDS, 0755);
+    for (int i = 0; i < nbShards; i++) {
+        if (tFlots[i] == NULL && complet == 0) continue; // Fichier à jour
+        tInfos[i].nb = 0; // Intervalle recalculé pendant l'écriture
+        tInfos[i].refMin = INT_MAX;
+        tInfos[i].refMax = INT_MIN;
+        if (tFlots[i] == NULL) continue; // Fichier à jour, intervalle tout de même recalculé
+        snprintf(chemin, sizeof(chemin), "%s/%d.don", DOSSIER_SHARDS, tDpts[i]);
+        tFlots[i] = ouvrirTemporaire(chemin);
+        if (tFlots[i] == NULL) ok = 0;
+    }
+
+    if (ok == 1) {
+        for (int i = 0; i < o->tlog; i++) {
+            pos = 0;
+            while (tDpts[pos] != dptOffre(o, i)) pos++;
+            if (tFlots[pos] == NULL && complet == 0) continue;
+            if (tFlots[pos] != NULL) ecrireOffre(tFlots[pos], o, i);
+            tInfos[pos].nb++;
+            if (o->tRef[i] < tInfos[pos].refMin) tInfos[pos].refMin = o->tRef[i];
+            if (o->tRef[i] > tInfos[pos].refMax) tInfos[pos].refMax = o->tRef[i];
+        }
+    }
+
+    for (int i = 0; i < nbShards; i++) {
+        if (tFlots[i] == NULL) continue;
+        snprintf(chemin, sizeof(chemin), "%s/%d.don", DOSSIER_SHARDS, tDpts[i]);
+        if (publierTemporaire(tFlots[i], chemin, ok) == 1) {
+            pthread_mutex_lock(&verrouShards);
+            tShards[i].sauve = versionEcrite;
+            tShards[i].nb = tInfos[i].nb;
+            tShards[i].refMin = tInfos[i].refMin;
+            tShards[i].refMax = tInfos[i].refMax;
+            pthread_mutex_unlock(&verrouShards);
+            nb++;
+        }
+        else ok = 0;
+    }
+    if (complet == 1 && ok == 1) { // Intervalles des départements non réécrits, relevés dans la version des fichiers
+        pthread_mutex_lock(&verrouShards);
+        for (int i = 0; i < nbShards; i++) {
+            tShards[i].nb = tInfos[i].nb;
+            tShards[i].refMin = tInfos[i].refMin;
+            tShards[i].refMax = tInfos[i].refMax;
+        }
+        pthread_mutex_unlock(&verrouShards);
+    }
+
+    // Intervalles changés : le manifeste est réécrit avec les fichiers
+    if (ok == 1 && (manifeste == 1 || nb > 0 || complet == 1)) {
+        flot = ouvrirTemporaire(FICHIER_MANIFESTE);
+        if (flot == NULL) ok = 0;
+        else {
+            for (int i = 0; i < nbShards; i++) fprintf(flot, "%d %d %d %d\n", tDpts[i], tInfos[i].nb, tInfos[i].refMin, tInfos[i].refMax);
+            if (publierTemporaire(flot, FICHIER_MANIFESTE, 1) == -1) ok = 0;
+        }
+    }
+    synchroniserDossier(DOSSIER_SHARDS);
+    free(tFlots);
+    free(tDpts);
+    free(tInfos);
+
+    if (ok == 0) {
+        if (manifeste == 1 || nb > 0) {
+            pthread_mutex_lock(&verrouShards);
+            manifesteModifie = 1; // À réécrire à la prochaine sauvegarde
+            pthread_mutex_unlock(&verrouShards);
+        }
+        return -1; // Problème d'écriture
+    }
+    modeShards = 1;
+    return nb;
+}
+
+/**
+ * \brief Découpe "offrestage.don" en un fichier par département accompagné d'un manifeste.
+ * 
+ * Les lancements suivants du programme utiliseront alors les fichiers découpés.
+ * Les tableaux sont dimensionnés d'après la taille du fichier ; s'il contient
+ * malgré tout plus d'offres, rien n'est écrit.
+ * 
+ * \return Le nombre de fichiers de département écrits, -1 en cas d'erreur.
+ */
+int decouperOffres(void) {
+    Stockage s;
+    Offres *o = &s.offres;
+    struct stat infos;
+    int code;
+
+    if (stat(FICHIER_OFFRES, &infos) == -1) return -1;
+    if (creerStockage(&s, (int)(infos.st_size / 4 + 1), 1) == -1) return -1; // Un enregistrement occupe au moins 4 octets
+
+    code = lireFichierOffres(FICHIER_OFFRES, o);
+    if (code == 1) code = trierOffres(o);
+    if (code == 1) {
+        tlogShards = 0;
+        code = ecrireShards(o, 1, 1, 0);
+    }
+    else code = -1; // Fichier illisible ou tronqué
+    libererStockage(&s);
+    return code;
+}
+
+/**
+ * \brief Charge les départements découpés pas encore en mémoire qui répondent à un critère.
+ * 
+ * Les fichiers retenus sont ajoutés à la fin des tableaux, qui ne sont remis dans
+ * l'ordre des références qu'une fois, à la fin. En cas d'erreur, rien n'est gardé.
+ * 
+ * \param s Stockage des données.
+ * \param dpt Département à charger, ou -1 pour tous ceux dont l'intervalle des références rencontre [refMin, refMax].
+ * \param refMin Plus petite référence cherchée.
+ * \param refMax Plus grande référence cherchée.
+ * \return 1 si les offres sont en mémoire, -1 en cas d'erreur de lecture ou d'allocation, -2 si le tableau est trop petit.
+ */
+int chargerShards(Stockage *s, int dpt, int refMin, int refMax) {
+    Offres *o = &s->offres;
+    char chemin[64];
+    struct stat infos;
+    int *tDpts, nb = 0, debut = o->tlog, code = 1, fd;
+
+    if (modeShards == 0) return 1; // Tout est déjà en mémoire
+
+    // Départements à lire, relevés sous verrou
+    pthread_mutex_lock(&verrouShards);
+    tDpts = (int *)malloc((tlogShards + 1) * sizeof(int));
+    if (tDpts == NULL) {
+        pthread_mutex_unlock(&verrouShards);
+        return -1; // Problème d'allocation
+    }
+    for (int i = 0; i < tlogShards; i++) {
+        if (tShards[i].charge == 1) continue;
+        if (dpt == -1 ? tShards[i].refMin <= refMax && tShards[i].refMax >= refMin : tShards[i].dpt == dpt) tDpts[nb++] = tShards[i].dpt;
+    }
+    pthread_mutex_unlock(&verrouShards);
+
+    fd = verrouillerDonnees(LOCK_SH);
+    for (int k = 0; k < nb && code == 1; k++) {
+        snprintf(chemin, sizeof(chemin), "%s/%d.don", DOSSIER_SHARDS, tDpts[k]);
+        if (stat(chemin, &infos) == -1) continue; // Un fichier absent est un département vide
+        code = lireFichierOffres(chemin, o);
+    }
+    deverrouillerDonnees(fd);
+    if (code == 1 && o->tlog > debut) code = trierOffres(o);
+    if (code != 1) {
+        o->tlog = debut; // Offres déjà en mémoire intactes (le tri ne touche à rien s'il échoue)
+        free(tDpts);
+        return code;
+    }
+
+    pthread_mutex_lock(&verrouShards);
+    for (int k = 0; k < nb; k++) {
+        for (int i = 0; i < tlogShards; i++) {
+            if (tShards[i].dpt == tDpts[k]) tShards[i].charge = 1;
+        }
+    }
+    pthread_mutex_unlock(&verrouShards);
+    free(tDpts);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Charge les offres d'un département, si elles ne sont pas déjà en mémoire.
+ * 
+ * À appeler avant d'ajouter une offre au département : son fichier sera réécrit
+ * avec toutes ses offres.
+ * 
+ * \param s Stockage des données.
+ * \param dpt Numéro du département.
+ * \return 1 si les offres sont en mémoire, -1 en cas d'erreur de lecture ou d'allocation, -2 si le tableau est trop petit.
+ */
+int chargerDepartement(Stockage *s, int dpt) {
+    return chargerShards(s, dpt, 0, 0);
+}
+
+/**
+ * \brief Charge les départements qui peuvent contenir des références d'une plage donnée.
+ * 
+ * \param s Stockage des données.
+ * \param refMin Plus petite référence cherchée.
+ * \param refMax Plus grande référence cherchée.
+ * \return 1 si les offres sont en mémoire, -1 en cas d'erreur de lecture ou d'allocation, -2 si le tableau est trop petit.
+ */
+int chargerPlageRef(Stockage *s, int refMin, int refMax) {
+    return chargerShards(s, -1, refMin, refMax);
+}
+
+/**
+ * \brief Charge toutes les offres (avant un parcours de toutes les offres).
+ * 
+ * \param s Stockage des données.
+ * \return 1 si les offres sont en mémoire, -1 en cas d'erreur de lecture ou d'allocation, -2 si le tableau est trop petit.
+ */
+int chargerToutesOffres(Stockage *s) {
+    return chargerShards(s, -1, INT_MIN, INT_MAX);
+}
+
+/**
+ * \brief Indique si une référence peut appartenir à un département pas encore chargé.
+ * 
+ * \param ref Numéro de référence.
+ * \return 1 si un département non chargé peut contenir la référence, 0 sinon.
+ */
+int offreHorsMemoire(int ref) {
+    int hors = 0;
+
+    pthread_mutex_lock(&verrouShards);
+    for (int i = 0; i < tlogShards && hors == 0; i++) {
+        if (tShards[i].charge == 0 && tShards[i].refMin <= ref && ref <= tShards[i].refMax) hors = 1;
+    }
+    pthread_mutex_unlock(&verrouShards);
+    return hors;
+}
+
+
+/**
+ * \brief Compte les départements dont les offres ne sont pas en mémoire.
+ * 
+ * \return Le nombre de départements non chargés (0 hors du mode découpé).
+ */
+int departementsNonCharges(void) {
+    int nb = 0;
+
+    pthread_mutex_lock(&verrouShards);
+    for (int i = 0; i < tlogShards; i++) {
+        if (tShards[i].charge == 0) nb++;
+    }
+    pthread_mutex_unlock(&verrouShards);
+    return nb;
+}
+
+
+/**
+ * \brief Sauvegarde le dernier instantané publié s'il est plus récent que les fichiers.
+ * 
+ * \return 1 si une sauvegarde a été faite, 0 si les fichiers étaient à jour, -1 en cas d'erreur.
+ */
+int sauvegarderInstantane(void) {
+    Instantane *inst;
+    int code = 0, dejaSauvee;
+
+    inst = epinglerInstantane();
+    if (inst == NULL) return 0; // Rien de publié
+
+    pthread_mutex_lock(&verrouSauvegarde);
+    dejaSauvee = inst->version == versionSauvee;
+    pthread_mutex_unlock(&verrouSauvegarde);
+
+    if (dejaSauvee == 0) {
+        code = sauvegarderDonnees(&inst->offres, &inst->etudiants, inst->tAttente, inst->lgAttente, inst->version);
+        if (code == 1) {
+            pthread_mutex_lock(&verrouSauvegarde);
+            versionSauvee = inst->version;
+            pthread_mutex_unlock(&verrouSauvegarde);
+        }
+        else {
+            pthread_mutex_lock(&verrouSauvegarde);
+            echecsSauvegarde++; // Signalé par l'interface (voir echecsSauvegardeAuto)
+            causeEchecSauvegarde = code;
+            pthread_mutex_unlock(&verrouSauvegarde);
+        }
+    }
+    libererInstantane(inst);
+    return code;
+}
+
+/**
+ * \brief Boucle du fil de sauvegarde automatique.
+ * 
+ * Se réveille toutes les INTERVALLE_SAUVEGARDE secondes, ou dès qu'une sauvegarde
+ * est demandée ; toutes les modifications faites entre deux réveils sont écrites
+ * en une seule fois.
+ * 
+ * \param arg Inutilisé.
+ * \return NULL.
+ */
+void *boucleSauvegarde(void *arg) {
+    struct timespec echeance;
+    (void)arg;
+
+    pthread_mutex_lock(&verrouSauvegarde);
+    while (arretSauvegarde == 0) {
+        if (sauvegardeDemandee == 0) {
+            clock_gettime(CLOCK_REALTIME, &echeance);
+            echeance.tv_sec += INTERVALLE_SAUVEGARDE;
+            pthread_cond_timedwait(&condSauvegarde, &verrouSauvegarde, &echeance);
+        }
+        if (arretSauvegarde == 1) break;
+        sauvegardeDemandee = 0;
+
+        pthread_mutex_unlock(&verrouSauvegarde);
+        sauvegarderInstantane();
+        pthread_mutex_lock(&verrouSauvegarde);
+    }
+    pthread_mutex_unlock(&verrouSauvegarde);
+    return NULL;
+}
+
+/**
+ * \brief Démarre le fil de sauvegarde automatique.
+ * 
+ * Les données doivent avoir été chargées et un premier instantané publié ; la
+ * dernière version publiée est sauvegardée à l'arrêt, y compris à la sortie du programme.
+ * 
+ * \return 1 si le fil a démarré, -1 sinon.
+ */
+int demarrerSauvegardeAuto(void) {
+    static int atexitFait = 0;
+    Instantane *inst;
+
+    if (sauvegardeActive == 1) return 1; // Déjà démarrée
+
+    inst = epinglerInstantane();
+    versionSauvee = inst == NULL ? 0 : inst->version; // Les fichiers viennent d'être lus
+    libererInstantane(inst);
+
+    arretSauvegarde = 0;
+    sauvegardeDemandee = 0;
+    if (pthread_create(&filSauvegarde, NULL, boucleSauvegarde, NULL) != 0) return -1;
+    sauvegardeActive = 1;
+
+    if (atexitFait == 0) {
+        atexit(arreterSauvegardeAuto);
+        atexitFait = 1;
+    }
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Demande au fil de sauvegarde d'écrire le dernier instantané sans attendre son prochain réveil.
+ * 
+ * Si le fil n'est pas démarré, la sauvegarde est faite immédiatement.
+ * 
+ * \return 1 si la sauvegarde est demandée ou faite, -1 en cas d'erreur.
+ */
+int demanderSauvegarde(void) {
+    if (sauvegardeActive == 0) return sauvegarderInstantane() < 0 ? -1 : 1; // Pas de fil : sauvegarde immédiate
+
+    pthread_mutex_lock(&verrouSauvegarde);
+    sauvegardeDemandee = 1;
+    pthread_cond_signal(&condSauvegarde);
+    pthread_mutex_unlock(&verrouSauvegarde);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Donne le nombre de sauvegardes qui ont échoué depuis le dernier appel.
+ * 
+ * Les sauvegardes du fil ne peuvent pas rendre leur code à l'interface : leurs
+ * échecs sont comptés ici, et l'interface les signale quand elle le peut.
+ * 
+ * \param cause Code rendu par sauvegarderDonnees lors du dernier échec (-1, -2 ou -3).
+ * \return Le nombre d'échecs, remis à 0.
+ */
+int echecsSauvegardeAuto(int *cause) {
+    int nb;
+
+    pthread_mutex_lock(&verrouSauvegarde);
+    nb = echecsSauvegarde;
+    *cause = causeEchecSauvegarde;
+    echecsSauvegarde = 0;
+    pthread_mutex_unlock(&verrouSauvegarde);
+    return nb;
+}
+
+/**
+ * \brief Arrête le fil de sauvegarde après avoir écrit la dernière version publiée.
+ * 
+ * Un échec de cette dernière sauvegarde est donné par echecsSauvegardeAuto.
+ */
+void arreterSauvegardeAuto(void) {
+    if (sauvegardeActive == 0) return;
+
+    pthread_mutex_lock(&verrouSauvegarde);
+    arretSauvegarde = 1;
+    pthread_cond_signal(&condSauvegarde);
+    pthread_mutex_unlock(&verrouSauvegarde);
+    pthread_join(filSauvegarde, NULL);
+    sauvegardeActive = 0;
+
+    sauvegarderInstantane(); // Dernière version
+}
+
+
+/**
+ * \brief Trie les tableaux des stages par numéro de référence croissant.
+ * 
+ * Le fichier étant sauvegardé dans l'ordre des références, les données sont déjà
+ * triées dans le cas courant et le tri ne coûte alors qu'un seul parcours. Sinon,
+ * les clés (référence << 32 | position) sont triées par qsort, puis chaque colonne
+ * est réordonnée une seule fois selon la permutation obtenue (les colonnes
+ * compactes en passant par leurs accesseurs).
+ * 
+ * \param o Offres de stage.
+ * \return 1 si les tableaux sont triés, -1 en cas d'erreur d'allocation (tableaux inchangés).
+ */
+int trierOffres(Offres *o) {
+    int *tCol[4] = {o->tRef, o->tEtu1, o->tEtu2, o->tEtu3}, *tRef = o->tRef, *tmp, i = 1, tlog = o->tlog;
+    long long *tCles;
+
+    while (i < tlog && tRef[i - 1] <= tRef[i]) i++;
+    if (i >= tlog) return 1; // Déjà trié
+
+    tCles = (long long *)malloc(tlog * sizeof(long long));
+    tmp = (int *)malloc(tlog * sizeof(int));
+    if (tCles == NULL || tmp == NULL) {
+        free(tCles);
+        free(tmp);
+        return -1; // Problème d'allocation
+    }
+
+    // Position en partie basse : l'ordre d'origine départage les références égales
+    for (i = 0; i < tlog; i++) tCles[i] = ((long long)tRef[i] << 32) | (unsigned int)i;
+    qsort(tCles, tlog, sizeof(long long), comparerCles);
+
+    for (int c = 0; c < 4; c++) {
+        for (i = 0; i < tlog; i++) tmp[i] = tCol[c][tCles[i] & 0xFFFFFFFF];
+        memcpy(tCol[c], tmp, tlog * sizeof(int));
+    }
+    for (i = 0; i < tlog; i++) tmp[i] = dptOffre(o, tCles[i] & 0xFFFFFFFF);
+    for (i = 0; i < tlog; i++) fixerDpt(o, i, tmp[i]);
+    for (i = 0; i < tlog; i++) tmp[i] = candidOffre(o, tCles[i] & 0xFFFFFFFF);
+    for (i = 0; i < tlog; i++) fixerCandid(o, i, tmp[i]);
+    for (i = 0; i < tlog; i++) tmp[i] = pourvuOffre(o, tCles[i] & 0xFFFFFFFF);
+    for (i = 0; i < tlog; i++) fixerPourvu(o, i, tmp[i]);
+    free(tCles);
+    free(tmp);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Recherche dichotomique d'une référence dans le tableau trié des références.
+ * 
+ * \param tRef[] Tableau des références des stages (trié par ordre croissant).
+ * \param tlog Taille logique du tableau.
+ * \param ref Numéro de référence recherché.
+ * \param trouve Mis à 1 si la référence existe, 0 sinon.
+ * \return La position de la référence si elle existe, sinon la position où elle devrait être insérée.
+ */
+int rechercheDichoRef(int tRef[], int tlog, int ref, int *trouve) {
+    int inf = 0, sup = tlog - 1, m;
+
+    while (inf <= sup) {
+        m = (inf + sup) / 2;
+        if (tRef[m] == ref) {
+            *trouve = 1;
+            return m;
+        }
+        if (tRef[m] < ref) inf = m + 1;
+        else sup = m - 1;
+    }
+    *trouve = 0;
+    return inf;
+}
+
+/**
+ * \brief Donne la plus petite référence strictement supérieure à une référence donnée.
+ * 
+ * \param tRef[] Tableau des références des stages (trié par ordre croissant).
+ * \param tlog Taille logique du tableau.
+ * \param ref Numéro de référence de départ.
+ * \return La référence suivante, -1 s'il n'y en a pas.
+ */
+int successeurRef(int tRef[], int tlog, int ref) {
+    int trouve, pos;
+
+    pos = rechercheDichoRef(tRef, tlog, ref, &trouve);
+    if (trouve == 1) pos++;
+    if (pos >= tlog) return -1; // Aucune référence après
+    return tRef[pos];
+}
+
+/**
+ * \brief Donne la plus grande référence strictement inférieure à une référence donnée.
+ * 
+ * \param tRef[] Tableau des références des stages (trié par ordre croissant).
+ * \param tlog Taille logique du tableau.
+ * \param ref Numéro de référence de départ.
+ * \return La référence précédente, -1 s'il n'y en a pas.
+ */
+int predecesseurRef(int tRef[], int tlog, int ref) {
+    int trouve, pos;
+
+    pos = rechercheDichoRef(tRef, tlog, ref, &trouve);
+    if (pos == 0) return -1; // Aucune référence avant
+    return tRef[pos - 1];
+}
+
+/**
+ * \brief Donne la première référence libre à partir d'une référence donnée.
+ * 
+ * \param tRef[] Tableau des références des stages (trié par ordre croissant).
+ * \param tlog Taille logique du tableau.
+ * \param ref Numéro de référence de départ.
+ * \return La première référence supérieure ou égale à ref qui n'est pas utilisée.
+ */
+int prochaineRefLibre(int tRef[], int tlog, int ref) {
+    int trouve, pos;
+
+    pos = rechercheDichoRef(tRef, tlog, ref, &trouve);
+    while (pos < tlog && tRef[pos] == ref) {
+        ref++;
+        pos++;
+    }
+    return ref;
+}
+
+/**
+ * \brief Commence une transaction : les modifications suivantes pourront être annulées.
+ */
+void debutTransaction(void) {
+    tlogJournal = 0;
+    journalIncomplet = 0;
+    transactionActive = 1;
+}
+
+/**
+ * \brief Valide la transaction en cours et libère son journal.
+ */
+void validerTransaction(void) {
+    publierEvenements();
+    free(tJournal);
+    tJournal = NULL;
+    tlogJournal = 0;
+    tmaxJournal = 0;
+    journalIncomplet = 0;
+    transactionActive = 0;
+}
+
+/**
+ * \brief Ajoute une entrée au journal de la transaction en cours (agrandi au besoin).
+ * 
+ * \param entree Entrée à ajouter.
+ * \return 1 si l'entrée a été ajoutée, 0 si aucune transaction n'est active, -1 en cas d'erreur d'allocation.
+ */
+int journaliser(EntreeJournal entree) {
+    EntreeJournal *nouveau;
+
+    if (transactionActive == 0) return 0; // Rien à journaliser
+
+    if (tlogJournal == tmaxJournal) {
+        int tmax = tmaxJournal == 0 ? 64 : tmaxJournal * 2;
+        nouveau = (EntreeJournal *)realloc(tJournal, tmax * sizeof(EntreeJournal));
+        if (nouveau == NULL) {
+            journalIncomplet = 1;
+            return -1; // Problème d'allocation
+        }
+        tJournal = nouveau;
+        tmaxJournal = tmax;
+    }
+    tJournal[tlogJournal++] = entree;
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Enregistre dans le journal l'état d'une offre avant sa modification.
+ * 
+ * \param type JOURNAL_AJOUT, JOURNAL_SUPPR ou JOURNAL_MODIF.
+ * \param pos Position de l'offre.
+ * \param o Offres de stage.
+ */
+void journaliserOffre(int type, int pos, Offres *o) {
+    EntreeJournal entree;
+
+    entree.type = type;
+    entree.pos = pos;
+    lireLigneOffre(o, pos, entree.tLigne);
+    entree.note = 0;
+
+    marquerModification();
+    marquerShardModifie(entree.tLigne[1]);
+    // Une offre ajoutée n'avait pas de ligne avant la modification
+    noterModification(1, o->tRef[pos], type == JOURNAL_AJOUT ? MODIF_ABSENTE : MODIF_LIGNE, entree.tLigne, 0);
+    if (transactionActive == 0) return;
+    journaliser(entree);
+}
+
+/**
+ * \brief Enregistre dans le journal l'état d'un étudiant avant sa modification.
+ * 
+ * \param type JOURNAL_STAGE ou JOURNAL_NOTE.
+ * \param pos Position de l'étudiant.
+ * \param refStage Référence du stage de l'étudiant avant modification.
+ * \param note Note de l'étudiant avant modification.
+ */
+void journaliserEtudiant(int type, int pos, int refStage, float note) {
+    EntreeJournal entree;
+    int tAvant[7] = {refStage};
+
+    marquerModification();
+    noterModification(0, pos, type == JOURNAL_STAGE ? MODIF_STAGE : MODIF_NOTE, tAvant, note);
+    if (transactionActive == 0) return;
+
+    entree.type = type;
+    entree.pos = pos;
+    entree.tLigne[0] = refStage;
+    entree.note = note;
+    journaliser(entree);
+}
+
+/**
+ * \brief Retire l'offre située à une position donnée en décalant les suivantes.
+ * 
+ * \param o Offres de stage (une de moins).
+ * \param pos Position de l'offre à retirer.
+ */
+void retirerOffre(Offres *o, int pos) {
+    for (int j = pos; j < o->tlog - 1; j++) {
+        o->tRef[j] = o->tRef[j + 1];
+        fixerDpt(o, j, dptOffre(o, j + 1));
+        fixerPourvu(o, j, pourvuOffre(o, j + 1));
+        fixerCandid(o, j, candidOffre(o, j + 1));
+        o->tEtu1[j] = o->tEtu1[j + 1];
+        o->tEtu2[j] = o->tEtu2[j + 1];
+        o->tEtu3[j] = o->tEtu3[j + 1];
+    }
+    o->tlog--;
+}
+
+/**
+ * \brief Annule toutes les modifications de la transaction en cours.
+ * 
+ * Le journal est rejoué à l'envers ; le coût ne dépend que du nombre de
+ * modifications faites depuis le début de la transaction.
+ * 
+ * \param s Stockage des données.
+ * \return Le nombre de modifications annulées, -1 si aucune transaction n'est active, -2 si le journal est incomplet.
+ */
+int annulerTransaction(Stockage *s) {
+    Offres *o = &s->offres;
+    Etudiants *etudiants = &s->etudiants;
+    int nb = tlogJournal, pos, trouve;
+    EntreeJournal *e;
+
+    if (transactionActive == 0) return -1; // Pas de transaction
+    if (journalIncomplet == 1) return -2; // Annulation impossible
+
+    for (int i = tlogJournal - 1; i >= 0; i--) {
+        e = &tJournal[i];
+        pos = e->pos;
+        marquerModification(); // Une version par ligne rétablie : les images d'avant restent ordonnées
+
+        // Ligne rétablie : à réécrire, même si sa modification était déjà sauvegardée
+        if (e->type == JOURNAL_STAGE) {
+            int tAvant[7] = {etudiants->tRefStage[pos]};
+            noterModification(0, pos, MODIF_STAGE, tAvant, 0);
+        }
+        else if (e->type == JOURNAL_NOTE) noterModification(0, pos, MODIF_NOTE, NULL, noteEtudiant(etudiants, pos));
+        else if (e->type == JOURNAL_ATTENTE_AJOUT || e->type == JOURNAL_ATTENTE_RETRAIT) { // L'annulation fait l'inverse
+            int tAvant[7] = {e->tLigne[0], e->tLigne[1], e->tLigne[2]};
+            noterModification(1, e->tLigne[0], e->type == JOURNAL_ATTENTE_AJOUT ? MODIF_ATTENTE_RETRAIT : MODIF_ATTENTE_AJOUT, tAvant, 0);
+        }
+        else {
+            marquerShardModifie(e->tLigne[1]);
+            // Un département chargé depuis a pu décaler les lignes : la place est retrouvée par la référence
+            pos = rechercheDichoRef(o->tRef, o->tlog, e->tLigne[0], &trouve);
+            if (trouve == 0) noterModification(1, e->tLigne[0], MODIF_ABSENTE, NULL, 0);
+            else {
+                int tLigne[7];
+                lireLigneOffre(o, pos, tLigne);
+                noterModification(1, e->tLigne[0], MODIF_LIGNE, tLigne, 0);
+            }
+        }
+
+        switch (e->type) {
+            case JOURNAL_AJOUT:
+                retirerOffre(o, pos);
+                break;
+
+            case JOURNAL_SUPPR:
+                decalerAdroite(o, pos);
+                // Fall through - la ligne est ensuite restaurée comme une modification
+            case JOURNAL_MODIF:
+                ecrireLigneOffre(o, pos, e->tLigne);
+                break;
+
+            case JOURNAL_STAGE:
+                etudiants->tRefStage[pos] = e->tLigne[0];
+                break;
+
+            case JOURNAL_NOTE:
+                fixerNote(etudiants, pos, e->note);
+                break;
+
+            case JOURNAL_ATTENTE_AJOUT:
+                retirerAttente(&s->attentes, e->tLigne[0], e->tLigne[2]);
+                break;
+
+            case JOURNAL_ATTENTE_RETRAIT: // Maillons rendus à la liste libre : la réinsertion n'échoue pas
+                insererAttente(&s->attentes, e->tLigne[0], e->tLigne[1], e->tLigne[2]);
+                break;
+        }
+    }
+    tlogJournal = 0;
+    lgEvenements = 0; // Les événements annulés ne sont jamais publiés
+    return nb;
+}
+
+
+/**
+ * \brief Signale que les données ont changé depuis le dernier instantané.
+ */
+void marquerModification(void) {
+    pthread_mutex_lock(&verrouInstantane);
+    version++;
+    pthread_mutex_unlock(&verrouInstantane);
+}
+
+/**
+ * \brief Donne la version courante des données.
+ * 
+ * \return Le numéro de version, augmenté à chaque modification.
+ */
+int versionDonnees(void) {
+    int v;
+    pthread_mutex_lock(&verrouInstantane);
+    v = version;
+    pthread_mutex_unlock(&verrouInstantane);
+    return v;
+}
+
+/**
+ * \brief Convertit une note en centièmes, arrondie comme l'écriture "%.2f" des fichiers.
+ * 
+ * \param note Note à convertir.
+ * \return La note multipliée par 100 et arrondie (au pair le plus proche en cas d'égalité).
+ */
+int centiemes(float note) {
+    double v = (double)note * 100; // Produit exact : pas de double arrondi
+    long long c = (long long)v;
+    double reste = v - c;
+
+    if (reste > 0.5 || (reste == 0.5 && c % 2 != 0)) c++;
+    else if (reste < -0.5 || (reste == -0.5 && c % 2 != 0)) c--;
+    return (int)c;
+}
+
+/**
+ * \brief Crée une copie figée des tableaux des offres et des étudiants.
+ * 
+ * Les colonnes sont copiées telles quelles, compactes, dans des blocs alloués
+ * comme ceux du stockage (voir allouerOffres) : le fil de sauvegarde les lit par
+ * les mêmes accesseurs. Les listes d'attente sont copiées mises à plat.
+ * 
+ * \param s Stockage des données.
+ * \return L'instantané (un lecteur : l'appelant), NULL en cas d'erreur d'allocation.
+ */
+Instantane *creerInstantane(Stockage *s) {
+    Offres *o = &s->offres, *copieO;
+    Etudiants *e = &s->etudiants, *copieE;
+    int tlogOffre = o->tlog, tlogEtu = e->tlog;
+    Instantane *inst;
+    size_t n = tlogOffre * sizeof(int), m = tlogEtu * sizeof(int);
+
+    inst = (Instantane *)malloc(sizeof(Instantane));
+    if (inst == NULL) return NULL; // Problème d'allocation
+    copieO = &inst->offres;
+    copieE = &inst->etudiants;
+    if (allouerOffres(copieO, tlogOffre) == -1) {
+        free(inst);
+        return NULL; // Problème d'allocation
+    }
+    if (allouerEtudiants(copieE, tlogEtu) == -1) {
+        libererOffres(copieO);
+        free(inst);
+        return NULL; // Problème d'allocation
+    }
+    if (aplatirAttentes(&s->attentes, &inst->tAttente, &inst->lgAttente) == -1) {
+        libererEtudiants(copieE);
+        libererOffres(copieO);
+        free(inst);
+        return NULL; // Problème d'allocation
+    }
+
+    inst->version = versionDonnees();
+    inst->nbLecteurs = 1;
+
+    copieO->tlog = tlogOffre;
+    memcpy(copieO->tBitsPourvu, o->tBitsPourvu, MOTS_POURVU(tlogOffre) * sizeof(unsigned long long));
+    memcpy(copieO->tRef, o->tRef, n);
+    memcpy(copieO->tNbCandid, o->tNbCandid, tlogOffre);
+    memcpy(copieO->tEtu1, o->tEtu1, n);
+    memcpy(copieO->tEtu2, o->tEtu2, n);
+    memcpy(copieO->tEtu3, o->tEtu3, n);
+    memcpy(copieO->tNumDpt, o->tNumDpt, tlogOffre * sizeof(short));
+
+    copieE->tlog = tlogEtu;
+    memcpy(copieE->tNumEtu, e->tNumEtu, m);
+    memcpy(copieE->tRefStage, e->tRefStage, m);
+    memcpy(copieE->tNote, e->tNote, tlogEtu * sizeof(short));
+    return inst;
+}
+
+/**
+ * \brief Publie un nouvel instantané si les données ont changé depuis le précédent.
+ * 
+ * Doit être appelée par le fil qui modifie les tableaux. L'ancien instantané reste
+ * valide pour les lecteurs qui l'ont épinglé et n'est libéré qu'après le dernier.
+ * Seul l'état validé est publié : pendant une transaction, ses événements ne sont
+ * pas encore écrits et une annulation peut la défaire, donc la sauvegarde
+ * automatique ne doit pas la voir.
+ * 
+ * \param s Stockage des données.
+ * \return 1 si un instantané a été publié, 0 s'il était déjà à jour ou si une transaction est en cours, -1 en cas d'erreur d'allocation.
+ */
+int publierInstantane(Stockage *s) {
+    Instantane *nouveau, *ancien;
+
+    if (transactionActive == 1) return 0; // Publié à la validation
+
+    pthread_mutex_lock(&verrouInstantane);
+    ancien = instantanePublie;
+    // Un département chargé à la demande ajoute des lignes sans changer la version
+    if (ancien != NULL && ancien->version == version && ancien->offres.tlog == s->offres.tlog) {
+        pthread_mutex_unlock(&verrouInstantane);
+        return 0; // Déjà à jour
+    }
+    pthread_mutex_unlock(&verrouInstantane);
+
+    nouveau = creerInstantane(s);
+    if (nouveau == NULL) return -1; // Problème d'allocation
+
+    pthread_mutex_lock(&verrouInstantane);
+    ancien = instantanePublie;
+    instantanePublie = nouveau;
+    pthread_mutex_unlock(&verrouInstantane);
+
+    if (ancien != NULL) libererInstantane(ancien);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Épingle le dernier instantané publié pour le lire sans bloquer les modifications.
+ * 
+ * \return L'instantané à relâcher avec libererInstantane, NULL si aucun n'a été publié.
+ */
+Instantane *epinglerInstantane(void) {
+    Instantane *inst;
+
+    pthread_mutex_lock(&verrouInstantane);
+    inst = instantanePublie;
+    if (inst != NULL) inst->nbLecteurs++;
+    pthread_mutex_unlock(&verrouInstantane);
+    return inst;
+}
+
+/**
+ * \brief Relâche un instantané ; il est libéré quand plus personne ne l'utilise.
+ * 
+ * \param inst Instantané à relâcher.
+ */
+void libererInstantane(Instantane *inst) {
+    int reste;
+
+    if (inst == NULL) return;
+    pthread_mutex_lock(&verrouInstantane);
+    reste = --inst->nbLecteurs;
+    pthread_mutex_unlock(&verrouInstantane);
+
+    if (reste == 0) {
+        libererOffres(&inst->offres);
+        libererEtudiants(&inst->etudiants);
+        free(inst->tAttente);
+        free(inst);
+    }
+}
+
+
+/**
+ * \brief Retrouve le dernier numéro de séquence du flux d'événements.
+ * 
+ * Seule la fin du fichier est lue. Pour un tube (FIFO), illisible par l'écrivain,
+ * le numéro est gardé à part dans FICHIER_SEQUENCE.
+ * 
+ * \return Le dernier numéro écrit, 0 si le flux est vide.
+ */
+long dernierNumeroEvenement(void) {
+    FILE *flot;
+    char ligne[256];
+    long num, dernier = 0;
+    struct stat infos;
+
+    if (stat(FICHIER_EVENEMENTS, &infos) != 0 || !S_ISREG(infos.st_mode)) return 0;
+
+    flot = fopen(FICHIER_EVENEMENTS, "r");
+    if (flot == NULL) return 0;
+    if (infos.st_size > (off_t)sizeof(ligne)) {
+        fseek(flot, -(long)sizeof(ligne), SEEK_END);
+        if (fgets(ligne, sizeof(ligne), flot) == NULL) { // Ligne coupée ignorée
+            fclose(flot);
+            return 0;
+        }
+    }
+    while (fgets(ligne, sizeof(ligne), flot) != NULL) {
+        if (sscanf(ligne, "%ld", &num) == 1) dernier = num;
+    }
+    fclose(flot);
+    return dernier;
+}
+
+/**
+ * \brief Ouvre le flux d'événements s'il ne l'est pas déjà.
+ * 
+ * L'ouverture ne bloque pas : un tube (FIFO) sans lecteur est simplement
+ * indisponible, et sera de nouveau essayé au prochain événement.
+ * 
+ * \return 1 si le flux est ouvert, -1 sinon.
+ */
+int ouvrirEvenements(void) {
+    int fd, options;
+
+    if (fdEvenements != -1) return 1;
+    fd = open(FICHIER_EVENEMENTS, O_WRONLY | O_APPEND | O_CREAT | O_NONBLOCK, 0644);
+    if (fd == -1) return -1; // Tube sans lecteur (ENXIO) ou problème d'ouverture
+    // Écritures bloquantes ensuite : un lecteur lent retient l'écrivain au lieu de perdre des événements
+    options = fcntl(fd, F_GETFL);
+    if (options != -1) fcntl(fd, F_SETFL, options & ~O_NONBLOCK);
+    signal(SIGPIPE, SIG_IGN); // Lecteur parti : l'écriture échoue (EPIPE) sans tuer le processus
+    fdEvenements = fd;
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Numérote et écrit des événements dans le flux, d'un seul bloc.
+ * 
+ * Les numéros sont pris sous verrou exclusif, partagé par tous les processus :
+ * la fin du fichier est relue à chaque fois, et pour un tube le dernier numéro
+ * est gardé dans FICHIER_SEQUENCE. Deux processus n'écrivent donc jamais le même numéro.
+ * 
+ * \param tLignes[] Événements, sans numéro, chacun terminé par un retour à la ligne.
+ * \param lg Nombre d'octets de tLignes.
+ * \return Le nombre d'événements écrits, -1 en cas d'erreur d'ouverture, d'allocation ou d'écriture.
+ */
+int ecrireEvenements(char tLignes[], int lg) {
+    struct stat infos;
+    char *tampon, texte[32];
+    long numero = 0;
+    int nb = 0, lgTampon = 0, debut = 0, fdVerrou, tube, code = 1;
+    ssize_t ecrit;
+
+    for (int i = 0; i < lg; i++) if (tLignes[i] == '\n') nb++;
+    if (nb == 0) return 0;
+    if (ouvrirEvenements() == -1) return -1;
+    tampon = (char *)malloc(lg + nb * 21); // Numéro (20 chiffres au plus) et espace par ligne
+    if (tampon == NULL) return -1; // Problème d'allocation
+
+    tube = fstat(fdEvenements, &infos) == 0 && !S_ISREG(infos.st_mode);
+    fdVerrou = tube == 1 ? open(FICHIER_SEQUENCE, O_RDWR | O_CREAT, 0644) : fdEvenements;
+    if (fdVerrou == -1 || flock(fdVerrou, LOCK_EX) == -1) {
+        if (tube == 1 && fdVerrou != -1) close(fdVerrou);
+        free(tampon);
+        return -1; // Numéros impossibles à réserver
+    }
+    if (tube == 0) numero = dernierNumeroEvenement();
+    else if (pread(fdVerrou, texte, sizeof(texte) - 1, 0) > 0) {
+        texte[sizeof(texte) - 1] = '\0';
+        numero = atol(texte);
+    }
+
+    for (int i = 0; i < lg; i++) {
+        if (tLignes[i] != '\n') continue;
+        lgTampon += sprintf(tampon + lgTampon, "%ld ", ++numero);
+        memcpy(tampon + lgTampon, tLignes + debut, i + 1 - debut);
+        lgTampon += i + 1 - debut;
+        debut = i + 1;
+    }
+    for (int fait = 0; fait < lgTampon && code == 1; fait += ecrit) {
+        ecrit = write(fdEvenements, tampon + fait, lgTampon - fait);
+        if (ecrit <= 0) code = -1;
+    }
+    if (tube == 1) {
+        if (code == 1) { // Numéros publiés : le processus suivant repart d'ici
+            snprintf(texte, sizeof(texte), "%ld\n", numero);
+            if (ftruncate(fdVerrou, 0) == 0 && pwrite(fdVerrou, texte, strlen(texte), 0) <= 0) code = -1;
+        }
+        close(fdVerrou); // Rend aussi le verrou
+    }
+    else flock(fdVerrou, LOCK_UN);
+    free(tampon);
+
+    if (code == -1) { // Lecteur du tube parti, disque plein... : réouverture au prochain événement
+        close(fdEvenements);
+        fdEvenements = -1;
+        return -1;
+    }
+    return nb;
+}
+
+/**
+ * \brief Émet un événement de modification.
+ * 
+ * Pendant une transaction, l'événement est gardé en mémoire jusqu'à sa validation ;
+ * sinon il est écrit tout de suite.
+ * 
+ * \param format Format au sens de printf (par exemple "AJOUT %d %d").
+ */
+void emettreEvenement(const char *format, ...) {
+    char evenement[128], *nouveau;
+    va_list args;
+    int n;
+
+    va_start(args, format);
+    n = vsnprintf(evenement, sizeof(evenement), format, args);
+    va_end(args);
+    if (n < 0) return;
+    if (n >= (int)sizeof(evenement) - 1) n = sizeof(evenement) - 2; // Place du retour à la ligne
+
+    if (transactionActive == 0) {
+        evenement[n] = '\n';
+        ecrireEvenements(evenement, n + 1);
+        return;
+    }
+
+    if (lgEvenements + n + 1 > tmaxEvenements) {
+        int tmax = tmaxEvenements == 0 ? 1024 : tmaxEvenements * 2;
+        while (tmax < lgEvenements + n + 1) tmax *= 2;
+        nouveau = (char *)realloc(tEvenements, tmax);
+        if (nouveau == NULL) return; // Problème d'allocation : événement perdu
+        tEvenements = nouveau;
+        tmaxEvenements = tmax;
+    }
+    memcpy(tEvenements + lgEvenements, evenement, n);
+    lgEvenements += n;
+    tEvenements[lgEvenements++] = '\n';
+}
+
+/**
+ * \brief Écrit dans le flux les événements de la transaction qui vient d'être validée.
+ * 
+ * \return Le nombre d'événements écrits, -1 en cas d'erreur d'ouverture ou d'écriture.
+ */
+int publierEvenements(void) {
+    int nb = ecrireEvenements(tEvenements, lgEvenements); // Un seul bloc : les numéros de la transaction se suivent
+
+    lgEvenements = 0;
+    return nb;
+}
+
+
+/**
+ * \brief Associe à chaque stage l'étudiant qui y est affecté.
+ * 
+ * Un seul parcours des étudiants suffit : la position du stage de chacun est
+ * retrouvée par dichotomie dans le tableau trié des références.
+ * 
+ * \param o Offres de stage (triées par référence croissante).
+ * \param e Étudiants.
+ * \param tEtuAffecte[] Tableau rempli avec le numéro de l'étudiant affecté à chaque stage (0 si aucun).
+ */
+void construireAffectations(Offres *o, Etudiants *e, int tEtuAffecte[]) {
+    int trouve, pos;
+
+    for (int i = 0; i < o->tlog; i++) tEtuAffecte[i] = 0;
+
+    for (int j = 0; j < e->tlog; j++) {
+        if (e->tRefStage[j] == -1) continue; // Pas de stage
+        pos = rechercheDichoRef(o->tRef, o->tlog, e->tRefStage[j], &trouve);
+        if (trouve == 1 && tEtuAffecte[pos] == 0) tEtuAffecte[pos] = e->tNumEtu[j];
+    }
+}
+
+/**
+ * \brief Décalle à droite tout les tableaux des stages pour libérer une case.
+ * 
+ * \param o Offres de stage (une de plus).
+ * \param pos Position de la case à libérer.
+ */
+void decalerAdroite(Offres *o, int pos) {
+    for (int j = o->tlog; j > pos; j--) {
+        o->tRef[j] = o->tRef[j - 1];
+        fixerDpt(o, j, dptOffre(o, j - 1));
+        fixerPourvu(o, j, pourvuOffre(o, j - 1));
+        fixerCandid(o, j, candidOffre(o, j - 1));
+        o->tEtu1[j] = o->tEtu1[j - 1];
+        o->tEtu2[j] = o->tEtu2[j - 1];
+        o->tEtu3[j] = o->tEtu3[j - 1];
+    }
+    o->tlog++;
+}
+
+/**
+ * \brief Recherche la position d'un étudiant à partir de son numéro.
+ * 
+ * \param tNumEtu[] Tableau des numéros des étudiants.
+ * \param tlogEtu Taille logique du tableau d'étudiants.
+ * \param id Numéro de l'étudiant recherché.
+ * \return La position de l'étudiant, -1 s'il n'existe pas.
+ */
+int rechercherEtudiant(int tNumEtu[], int tlogEtu, int id) {
+    for (int i = 0; i < tlogEtu; i++) {
+        if (tNumEtu[i] == id) return i;
+    }
+    return -1; // Étudiant non trouvé
+}
+
+/**
+ * \brief Recherche les offres d'un département.
+ * 
+ * \param o Offres de stage.
+ * \param dpt Numéro du département recherché.
+ * \param tPos[] Tableau (de taille o->tlog) rempli avec les positions des offres trouvées, dans l'ordre des références.
+ * \return Le nombre d'offres trouvées.
+ */
+int offresDuDepartement(Offres *o, int dpt, int tPos[]) {
+    int nb = 0;
+
+    for (int i = 0; i < o->tlog; i++) {
+        if (dptOffre(o, i) == dpt) tPos[nb++] = i;
+    }
+    return nb;
+}
+
+/**
+ * \brief Fait descendre un élément dans un tas minimum d'étudiants ordonné par note.
+ * 
+ * \param tTas[] Tableau des positions d'étudiants formant le tas.
+ * \param taille Nombre d'éléments dans le tas.
+ * \param i Position de l'élément à faire descendre.
+ * \param e Étudiants (notes finales).
+ */
+void descendreTas(int tTas[], int taille, int i, Etudiants *e) {
+    int fils, tmp;
+
+    while (2 * i + 1 < taille) {
+        fils = 2 * i + 1;
+        if (fils + 1 < taille && noteEtudiant(e, tTas[fils + 1]) < noteEtudiant(e, tTas[fils])) fils++;
+        if (noteEtudiant(e, tTas[i]) <= noteEtudiant(e, tTas[fils])) return;
+        tmp = tTas[i]; tTas[i] = tTas[fils]; tTas[fils] = tmp;
+        i = fils;
+    }
+}
+
+/**
+ * \brief Sélectionne les k meilleurs étudiants sans stage à l'aide d'un tas borné à k éléments.
+ * 
+ * Le tas est reconstruit à chaque appel en un parcours des étudiants (O(n log k)) ;
+ * il n'est pas maintenu entre deux appels.
+ * 
+ * \param e Étudiants.
+ * \param k Nombre d'étudiants voulus.
+ * \param tMeilleurs[] Tableau (de taille k) rempli avec les positions des étudiants, de la meilleure note à la moins bonne.
+ * \return Le nombre d'étudiants sélectionnés.
+ */
+int meilleursSansStage(Etudiants *e, int k, int tMeilleurs[]) {
+    int taille = 0, pere, i, tmp;
+
+    if (k <= 0) return 0;
+
+    for (int j = 0; j < e->tlog; j++) {
+        if (e->tRefStage[j] != -1) continue; // Étudiant déjà affecté
+
+        if (taille < k) { // Tas pas encore plein : insertion puis remontée
+            i = taille++;
+            tMeilleurs[i] = j;
+            while (i > 0) {
+                pere = (i - 1) / 2;
+                if (noteEtudiant(e, tMeilleurs[pere]) <= noteEtudiant(e, tMeilleurs[i])) break;
+                tmp = tMeilleurs[i]; tMeilleurs[i] = tMeilleurs[pere]; tMeilleurs[pere] = tmp;
+                i = pere;
+            }
+        }
+        else if (noteEtudiant(e, j) > noteEtudiant(e, tMeilleurs[0])) { // Remplace la plus petite note
+            tMeilleurs[0] = j;
+            descendreTas(tMeilleurs, taille, 0, e);
+        }
+    }
+
+    // Vide le tas de la fin vers le début pour obtenir l'ordre décroissant
+    for (i = taille - 1; i > 0; i--) {
+        tmp = tMeilleurs[0]; tMeilleurs[0] = tMeilleurs[i]; tMeilleurs[i] = tmp;
+        descendreTas(tMeilleurs, i, 0, e);
+    }
+    return taille;
+}
+
+/**
+ * \brief Compare deux clés (numéro << 32 | position) pour qsort.
+ * 
+ * \param a Première clé.
+ * \param b Seconde clé.
+ * \return Négatif, nul ou positif selon l'ordre des clés.
+ */
+int comparerCles(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * \brief Indexe les étudiants par numéro : clés triées, recherchées par dichotomie.
+ * 
+ * \param ix Index à remplir (à libérer avec libererIndex).
+ * \param tNumEtu[] Tableau des numéros des étudiants.
+ * \param tlogEtu Taille logique du tableau d'étudiants.
+ * \return 1 si l'index a été construit, -1 en cas d'erreur d'allocation.
+ */
+int indexerEtudiants(IndexEtudiants *ix, int tNumEtu[], int tlogEtu) {
+    ix->tlog = tlogEtu;
+    ix->tCles = (long long *)malloc((tlogEtu + 1) * sizeof(long long));
+    if (ix->tCles == NULL) return -1; // Problème d'allocation
+
+    for (int i = 0; i < tlogEtu; i++) ix->tCles[i] = ((long long)tNumEtu[i] << 32) | (unsigned int)i;
+    qsort(ix->tCles, tlogEtu, sizeof(long long), comparerCles);
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Libère la mémoire d'un index des étudiants.
+ * 
+ * \param ix Index à libérer.
+ */
+void libererIndex(IndexEtudiants *ix) {
+    free(ix->tCles);
+    ix->tCles = NULL;
+}
+
+/**
+ * \brief Donne la position d'un étudiant à partir de son numéro.
+ * 
+ * \param ix Index des étudiants.
+ * \param num Numéro de l'étudiant.
+ * \return La position de l'étudiant, -1 s'il n'existe pas.
+ */
+int indiceEtudiant(IndexEtudiants *ix, int num) {
+    int deb = 0, fin = ix->tlog - 1, mil, cle;
+
+    while (deb <= fin) {
+        mil = (deb + fin) / 2;
+        cle = (int)(ix->tCles[mil] >> 32);
+        if (cle == num) return (int)(ix->tCles[mil] & 0xFFFFFFFF);
+        if (cle < num) deb = mil + 1;
+        else fin = mil - 1;
+    }
+    return -1;
+}
+
+/**
+ * \brief Construit la matrice des candidatures à partir des colonnes ETU1/ETU2/ETU3.
+ * 
+ * Les candidats dont le numéro n'existe pas dans la liste des étudiants sont ignorés.
+ * 
+ * \param m Matrice à remplir (à libérer avec libererMatrice).
+ * \param o Offres de stage.
+ * \param e Étudiants.
+ * \return 1 si la matrice a été construite, -1 en cas d'erreur d'allocation.
+ */
+int construireMatrice(MatriceCandidats *m, Offres *o, Etudiants *e) {
+    int *tCol[3] = {o->tEtu1, o->tEtu2, o->tEtu3}, tlogOffre = o->tlog, j, nb = 0;
+
+    m->tlogOffre = tlogOffre;
+    m->tDebut = (int *)malloc((tlogOffre + 1) * sizeof(int));
+    m->tColonnes = (int *)malloc((3 * (size_t)tlogOffre + 1) * sizeof(int));
+    if (indexerEtudiants(&m->index, e->tNumEtu, e->tlog) == -1 || m->tDebut == NULL || m->tColonnes == NULL) {
+        libererMatrice(m);
+        return -1; // Problème d'allocation
+    }
+
+    for (int i = 0; i < tlogOffre; i++) {
+        m->tDebut[i] = nb;
+        for (int c = 0; c < 3; c++) {
+            if (tCol[c][i] == 0) continue; // Emplacement vide
+            j = indiceEtudiant(&m->index, tCol[c][i]);
+            if (j != -1) m->tColonnes[nb++] = j;
+        }
+    }
+    m->tDebut[tlogOffre] = nb;
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Libère la mémoire d'une matrice des candidatures.
+ * 
+ * \param m Matrice à libérer.
+ */
+void libererMatrice(MatriceCandidats *m) {
+    free(m->tDebut);
+    free(m->tColonnes);
+    libererIndex(&m->index);
+    m->tDebut = NULL;
+    m->tColonnes = NULL;
+}
+
+/**
+ * \brief Compte les candidats connus d'une offre.
+ * 
+ * \param m Matrice des candidatures.
+ * \param pos Position de l'offre.
+ * \return Le nombre de candidats.
+ */
+int nbCandidatsLigne(MatriceCandidats *m, int pos) {
+    return m->tDebut[pos + 1] - m->tDebut[pos];
+}
+
+/**
+ * \brief Recherche les offres ayant au moins un candidat qui n'a pas encore de stage.
+ * 
+ * Seules les candidatures existantes sont parcourues.
+ * 
+ * \param m Matrice des candidatures.
+ * \param tRefStage[] Tableau des références de stages associés aux étudiants.
+ * \param tOffres[] Tableau (de taille tlogOffre) rempli avec les positions des offres trouvées.
+ * \param tNb[] Tableau (de taille tlogOffre) rempli avec le nombre de candidats sans stage de chaque offre trouvée.
+ * \return Le nombre d'offres trouvées.
+ */
+int offresCandidatSansStage(MatriceCandidats *m, int tRefStage[], int tOffres[], int tNb[]) {
+    int nb = 0, total;
+
+    for (int i = 0; i < m->tlogOffre; i++) {
+        total = 0;
+        for (int k = m->tDebut[i]; k < m->tDebut[i + 1]; k++) {
+            if (tRefStage[m->tColonnes[k]] == -1) total++;
+        }
+        if (total > 0) {
+            tOffres[nb] = i;
+            tNb[nb] = total;
+            nb++;
+        }
+    }
+    return nb;
+}
+
+
+/**
+ * \brief Initialise un filtre qui accepte toutes les offres.
+ * 
+ * \param f Filtre à initialiser.
+ */
+void filtreInit(Filtre *f) {
+    f->refMin = f->dptMin = f->pourvuMin = f->candidMin = INT_MIN;
+    f->refMax = f->dptMax = f->pourvuMax = f->candidMax = INT_MAX;
+    f->nbDpt = 0;
+}
+
+/**
+ * \brief Restreint un intervalle à son intersection avec [bas, haut].
+ * 
+ * \param min Borne basse de l'intervalle.
+ * \param max Borne haute de l'intervalle.
+ * \param bas Borne basse imposée.
+ * \param haut Borne haute imposée.
+ */
+void restreindre(int *min, int *max, int bas, int haut) {
+    if (bas > *min) *min = bas;
+    if (haut < *max) *max = haut;
+}
+
+/**
+ * \brief Lit un entier positif dans le texte d'un filtre.
+ * 
+ * \param p Position dans le texte, avancée après l'entier.
+ * \param val Entier lu.
+ * \return 1 si un entier a été lu, 0 sinon.
+ */
+int lireValeurFiltre(const char **p, int *val) {
+    long v = 0;
+
+    if (!isdigit((unsigned char)**p)) return 0;
+    while (isdigit((unsigned char)**p)) {
+        v = v * 10 + (**p - '0');
+        if (v > INT_MAX) return 0; // Dépassement
+        (*p)++;
+    }
+    *val = (int)v;
+    return 1;
+}
+
+/**
+ * \brief Restreint les départements acceptés à une liste (intersection avec la liste déjà présente).
+ * 
+ * \param f Filtre à restreindre.
+ * \param tListe[] Départements de la liste.
+ * \param nb Nombre de départements de la liste.
+ */
+void restreindreListe(Filtre *f, int tListe[], int nb) {
+    int nbCommun = 0;
+
+    if (f->nbDpt == 0) {
+        for (int i = 0; i < nb; i++) f->tDpt[i] = tListe[i];
+        f->nbDpt = nb;
+        return;
+    }
+    for (int i = 0; i < f->nbDpt; i++) {
+        for (int j = 0; j < nb; j++) {
+            if (f->tDpt[i] == tListe[j]) {
+                f->tDpt[nbCommun++] = f->tDpt[i];
+                break;
+            }
+        }
+    }
+    f->nbDpt = nbCommun;
+    if (nbCommun == 0) restreindre(&f->dptMin, &f->dptMax, 1, 0); // Aucun département possible
+}
+
+/**
+ * \brief Compile le texte d'un filtre en intervalles sur les colonnes des offres.
+ * 
+ * Critères reconnus (champs ref, dpt, pourvu, candid) : "champ=v", "champ=a-b",
+ * "champ<v", "champ<=v", "champ>v", "champ>=v", et "dpt=a,b,..." pour une liste.
+ * 
+ * \param texte Texte du filtre.
+ * \param f Filtre compilé.
+ * \return 1 si le filtre est valide, -1 en cas d'erreur de syntaxe.
+ */
+int compilerFiltre(const char *texte, Filtre *f) {
+    const char *p = texte;
+    char champ[16], op;
+    int lg, egal, val, haut, nb, *min, *max, tListe[NB_DPT_FILTRE];
+
+    filtreInit(f);
+    while (1) {
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '\0' || *p == '\n') break; // Fin du filtre
+
+        lg = 0;
+        while (isalpha((unsigned char)*p) && lg < 15) champ[lg++] = tolower((unsigned char)*p++);
+        champ[lg] = '\0';
+        if (strcmp(champ, "ref") == 0) { min = &f->refMin; max = &f->refMax; }
+        else if (strcmp(champ, "dpt") == 0) { min = &f->dptMin; max = &f->dptMax; }
+        else if (strcmp(champ, "pourvu") == 0) { min = &f->pourvuMin; max = &f->pourvuMax; }
+        else if (strcmp(champ, "candid") == 0) { min = &f->candidMin; max = &f->candidMax; }
+        else return -1; // Champ inconnu
+
+        egal = 0;
+        op = *p;
+        if (op != '=' && op != '<' && op != '>') return -1; // Opérateur inconnu
+        p++;
+        if (op != '=' && *p == '=') {
+            egal = 1;
+            p++;
+        }
+        if (lireValeurFiltre(&p, &val) == 0) return -1;
+
+        if (op == '<') restreindre(min, max, INT_MIN, egal ? val : val - 1);
+        else if (op == '>' && egal == 0 && val == INT_MAX) restreindre(min, max, INT_MAX, INT_MIN); // Rien au-delà : intervalle vide
+        else if (op == '>') restreindre(min, max, egal ? val : val + 1, INT_MAX);
+        else if (*p == '-') { // Plage a-b
+            p++;
+            if (lireValeurFiltre(&p, &haut) == 0) return -1;
+            restreindre(min, max, val, haut);
+        }
+        else if (*p == ',') { // Liste de départements
+            if (min != &f->dptMin) return -1;
+            tListe[0] = val;
+            nb = 1;
+            while (*p == ',') {
+                p++;
+                if (nb == NB_DPT_FILTRE || lireValeurFiltre(&p, &tListe[nb]) == 0) return -1;
+                nb++;
+            }
+            restreindreListe(f, tListe, nb);
+        }
+        else restreindre(min, max, val, val);
+
+        if (*p != ' ' && *p != '\t' && *p != '\0' && *p != '\n') return -1; // Critère mal terminé
+    }
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Recherche les offres qui vérifient un filtre compilé.
+ * 
+ * Les bornes de références réduisent le parcours, par dichotomie, à la plage
+ * concernée du tableau trié. Les autres critères sont évalués ensemble en un seul
+ * passage sans branchement : chaque intervalle est testé par une seule comparaison
+ * non signée, et la position est écrite à chaque tour puis conservée ou non.
+ * 
+ * \param o Offres de stage (triées par référence croissante).
+ * \param f Filtre compilé.
+ * \param tPos[] Tableau (de taille o->tlog) rempli avec les positions des offres trouvées, dans l'ordre des références.
+ * \return Le nombre d'offres trouvées.
+ */
+int filtrerOffres(Offres *o, Filtre *f, int tPos[]) {
+    unsigned int dptMin = f->dptMin, pourvuMin = f->pourvuMin, candidMin = f->candidMin;
+    unsigned int lgDpt, lgPourvu, lgCandid;
+    int debut = 0, fin = o->tlog, trouve, nb = 0, ok, dans, dpt;
+
+    if (f->refMin > f->refMax || f->dptMin > f->dptMax || f->pourvuMin > f->pourvuMax || f->candidMin > f->candidMax) return 0; // Filtre impossible
+    lgDpt = (unsigned int)f->dptMax - dptMin;
+    lgPourvu = (unsigned int)f->pourvuMax - pourvuMin;
+    lgCandid = (unsigned int)f->candidMax - candidMin;
+
+    // Index des références : seule la plage [refMin, refMax] est parcourue
+    if (f->refMin != INT_MIN) debut = rechercheDichoRef(o->tRef, o->tlog, f->refMin, &trouve);
+    if (f->refMax != INT_MAX) fin = rechercheDichoRef(o->tRef, o->tlog, f->refMax, &trouve) + trouve;
+
+    for (int i = debut; i < fin; i++) {
+        dpt = dptOffre(o, i);
+        ok = ((unsigned int)dpt - dptMin <= lgDpt)
+           & ((unsigned int)pourvuOffre(o, i) - pourvuMin <= lgPourvu)
+           & ((unsigned int)candidOffre(o, i) - candidMin <= lgCandid);
+        if (f->nbDpt > 0) {
+            dans = 0;
+            for (int d = 0; d < f->nbDpt; d++) dans |= dpt == f->tDpt[d];
+            ok &= dans;
+        }
+        tPos[nb] = i;
+        nb += ok;
+    }
+    return nb;
+}
+
+/**
+ * \brief Joue un tour de simulation : chaque offre non pourvue choisit un candidat libre.
+ * 
+ * Les offres sont examinées dans un ordre tiré au hasard ; un étudiant choisi
+ * n'est plus libre pour les offres suivantes. Le tirage ne dépend que de la
+ * graine et du numéro du tour, pas du fil qui le calcule.
+ * 
+ * \param sim Simulation en cours.
+ * \param tour Numéro du tour.
+ * \param tPlace[] Tableau de travail (un par étudiant).
+ * \param tOrdre[] Tableau de travail (un par offre).
+ * \return Le nombre de stages pourvus à la fin du tour.
+ */
+int tourSimulation(Simulation *sim, int tour, char tPlace[], int tOrdre[]) {
+    Instantane *inst = sim->inst;
+    unsigned int graine = sim->graine ^ ((unsigned int)tour * 2654435761u);
+    int nbPourvus = 0, nbSansStage = 0, i, j, tmp, p, choisi, nbLibres, tLibres[3];
+
+    for (j = 0; j < inst->etudiants.tlog; j++) tPlace[j] = inst->etudiants.tRefStage[j] != -1;
+    for (i = 0; i < inst->offres.tlog; i++) tOrdre[i] = i;
+    for (i = inst->offres.tlog - 1; i > 0; i--) { // Mélange de Fisher-Yates
+        j = rand_r(&graine) % (i + 1);
+        tmp = tOrdre[i]; tOrdre[i] = tOrdre[j]; tOrdre[j] = tmp;
+    }
+
+    for (int k = 0; k < inst->offres.tlog; k++) {
+        i = tOrdre[k];
+        if (pourvuOffre(&inst->offres, i) == 1) {
+            nbPourvus++;
+            continue;
+        }
+
+        nbLibres = 0;
+        for (int c = 0; c < 3; c++) {
+            p = sim->tCandPos[3 * i + c];
+            if (p != -1 && tPlace[p] == 0) tLibres[nbLibres++] = p;
+        }
+        if (nbLibres == 0) continue; // Aucun candidat libre
+
+        choisi = tLibres[0]; // POLITIQUE_ORDRE
+        if (sim->politique == POLITIQUE_NOTE) {
+            for (int c = 1; c < nbLibres; c++) {
+                if (noteEtudiant(&inst->etudiants, tLibres[c]) > noteEtudiant(&inst->etudiants, choisi)) choisi = tLibres[c];
+            }
+        }
+        else if (sim->politique == POLITIQUE_HASARD) choisi = tLibres[rand_r(&graine) % nbLibres];
+
+        tPlace[choisi] = 1;
+        nbPourvus++;
+    }
+
+    for (j = 0; j < inst->etudiants.tlog; j++) {
+        if (tPlace[j] == 0) nbSansStage++;
+    }
+    sim->tPourvus[tour] = nbPourvus;
+    sim->tSansStage[tour] = nbSansStage;
+    return nbPourvus;
+}
+
+/**
+ * \brief Fil de calcul de la simulation : prend les tours par lots jusqu'à épuisement.
+ * 
+ * \param arg Simulation en cours (Simulation *).
+ * \return NULL, ou (void *)-1 en cas d'erreur d'allocation.
+ */
+void *filSimulation(void *arg) {
+    Simulation *sim = (Simulation *)arg;
+    char *tPlace;
+    int *tOrdre, debut, fin;
+
+    tPlace = (char *)malloc(sim->inst->etudiants.tlog + 1);
+    tOrdre = (int *)malloc((sim->inst->offres.tlog + 1) * sizeof(int));
+    if (tPlace == NULL || tOrdre == NULL) {
+        free(tPlace);
+        free(tOrdre);
+        return (void *)-1; // Problème d'allocation
+    }
+
+    while (1) {
+        pthread_mutex_lock(&sim->verrou);
+        debut = sim->prochainTour;
+        sim->prochainTour += TOURS_PAR_LOT;
+        pthread_mutex_unlock(&sim->verrou);
+        if (debut >= sim->nbTours) break;
+
+        fin = debut + TOURS_PAR_LOT < sim->nbTours ? debut + TOURS_PAR_LOT : sim->nbTours;
+        for (int tour = debut; tour < fin; tour++) tourSimulation(sim, tour, tPlace, tOrdre);
+    }
+    free(tPlace);
+    free(tOrdre);
+    return NULL;
+}
+
+/**
+ * \brief Simule de nombreux tours d'affectation selon une politique, en parallèle.
+ * 
+ * \param inst Instantané épinglé des données (lu sans copie par tous les fils).
+ * \param politique Politique de choix du candidat (POLITIQUE_...).
+ * \param nbTours Nombre de tours à simuler.
+ * \param graine Graine des tirages au hasard.
+ * \param tPourvus[] Tableau (de taille nbTours) rempli avec le nombre de stages pourvus de chaque tour.
+ * \param tSansStage[] Tableau (de taille nbTours) rempli avec le nombre d'étudiants sans stage de chaque tour.
+ * \return 1 si la simulation s'est bien passée, -1 en cas d'erreur d'allocation.
+ */
+int simulerAffectations(Instantane *inst, int politique, int nbTours, unsigned int graine, int tPourvus[], int tSansStage[]) {
+    Simulation sim;
+    IndexEtudiants index;
+    pthread_t tFils[NB_FILS_MAX];
+    int *tCol[3] = {inst->offres.tEtu1, inst->offres.tEtu2, inst->offres.tEtu3}, nbFils, lances = 0;
+    long nb = sysconf(_SC_NPROCESSORS_ONLN);
+
+    // Numéros des candidats -> positions des étudiants, une fois pour tous les tours
+    sim.tCandPos = (int *)malloc((3 * inst->offres.tlog + 1) * sizeof(int));
+    if (sim.tCandPos == NULL || indexerEtudiants(&index, inst->etudiants.tNumEtu, inst->etudiants.tlog) == -1) {
+        free(sim.tCandPos);
+        return -1; // Problème d'allocation
+    }
+    for (int i = 0; i < inst->offres.tlog; i++) {
+        for (int c = 0; c < 3; c++) {
+            sim.tCandPos[3 * i + c] = tCol[c][i] == 0 ? -1 : indiceEtudiant(&index, tCol[c][i]);
+        }
+    }
+    libererIndex(&index);
+
+    sim.inst = inst;
+    sim.politique = politique;
+    sim.nbTours = nbTours;
+    sim.graine = graine;
+    sim.prochainTour = 0;
+    sim.tPourvus = tPourvus;
+    sim.tSansStage = tSansStage;
+    pthread_mutex_init(&sim.verrou, NULL);
+
+    if (nb < 1) nb = 1;
+    if (nb > NB_FILS_MAX) nb = NB_FILS_MAX;
+    nbFils = (int)nb;
+    if ((nbTours + TOURS_PAR_LOT - 1) / TOURS_PAR_LOT < nbFils) nbFils = (nbTours + TOURS_PAR_LOT - 1) / TOURS_PAR_LOT;
+
+    for (int f = 1; f < nbFils; f++) {
+        if (pthread_create(&tFils[lances], NULL, filSimulation, &sim) == 0) lances++;
+    }
+    filSimulation(&sim); // Le fil appelant participe aussi
+    for (int f = 0; f < lances; f++) pthread_join(tFils[f], NULL);
+    pthread_mutex_destroy(&sim.verrou);
+    free(sim.tCandPos);
+
+    // Un fil sans mémoire ne prend aucun lot : les tours distribués ont tous été joués
+    if (sim.prochainTour < nbTours) return -1;
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Calcule le minimum, le maximum et la moyenne d'une série.
+ * 
+ * \param t[] Série de valeurs.
+ * \param nb Nombre de valeurs (au moins 1).
+ * \param min Minimum de la série.
+ * \param max Maximum de la série.
+ * \param moyenne Moyenne de la série.
+ */
+void resumerSerie(int t[], int nb, int *min, int *max, double *moyenne) {
+    double somme = 0;
+
+    *min = t[0];
+    *max = t[0];
+    for (int i = 0; i < nb; i++) {
+        if (t[i] < *min) *min = t[i];
+        if (t[i] > *max) *max = t[i];
+        somme += t[i];
+    }
+    *moyenne = somme / nb;
+}
+
+/**
+ * \brief Compte une violation dans un rapport et garde la clé en exemple.
+ * 
+ * \param r Rapport à compléter.
+ * \param sorte Sorte de violation (VIOLATION_...).
+ * \param cle REF de l'offre ou NUM de l'étudiant en cause.
+ */
+void signalerViolation(Rapport *r, int sorte, int cle) {
+    if (r->tNb[sorte] < NB_EXEMPLES) r->tExemples[sorte][r->tNb[sorte]] = cle;
+    r->tNb[sorte]++;
+}
+
+/**
+ * \brief Vérifie une tranche d'étudiants : numéro unique, stage existant et offre marquée pourvue.
+ * 
+ * La tranche est prise à la fois dans les tableaux et dans l'index trié des numéros. Compte aussi, pour chaque offre, les étudiants qui y sont affectés.
+ * 
+ * \param arg Tranche à vérifier (Verification *).
+ * \return NULL.
+ */
+void *verifierTrancheEtudiants(void *arg) {
+    Verification *v = (Verification *)arg;
+    Offres *o = &v->s->offres;
+    Etudiants *e = &v->s->etudiants;
+    int pos, trouve, cle;
+
+    for (int j = v->debut; j < v->fin; j++) {
+        // Numéros voisins dans l'index trié : un doublon rendrait ambiguë la recherche par numéro
+        cle = (int)(v->index->tCles[j] >> 32);
+        if (j + 1 < e->tlog && (int)(v->index->tCles[j + 1] >> 32) == cle) signalerViolation(&v->rapport, VIOLATION_NUM_DOUBLE, cle);
+
+        if (e->tRefStage[j] == -1) continue; // Sans stage
+        pos = rechercheDichoRef(o->tRef, o->tlog, e->tRefStage[j], &trouve);
+        if (trouve == 0) {
+            // Offre d'un département pas encore chargé : rien à vérifier ici
+            if (offreHorsMemoire(e->tRefStage[j]) == 0) signalerViolation(&v->rapport, VIOLATION_REF_STAGE, e->tNumEtu[j]);
+            continue;
+        }
+        if (pourvuOffre(o, pos) != 1) signalerViolation(&v->rapport, VIOLATION_NON_POURVU, e->tNumEtu[j]);
+        __atomic_fetch_add(&v->tNbAffectes[pos], 1, __ATOMIC_RELAXED); // Plusieurs fils peuvent viser la même offre
+    }
+    return NULL;
+}
+
+/**
+ * \brief Vérifie une tranche d'offres : références uniques, affectations, candidats et CANDID.
+ * 
+ * \param arg Tranche à vérifier (Verification *), après la vérification de tous les étudiants.
+ * \return NULL.
+ */
+void *verifierTrancheOffres(void *arg) {
+    Verification *v = (Verification *)arg;
+    Offres *o = &v->s->offres;
+    int *tCol[3] = {o->tEtu1, o->tEtu2, o->tEtu3}, nbCandidats;
+
+    for (int i = v->debut; i < v->fin; i++) {
+        if (i + 1 < o->tlog && o->tRef[i + 1] == o->tRef[i]) signalerViolation(&v->rapport, VIOLATION_REF_DOUBLE, o->tRef[i]);
+        if (pourvuOffre(o, i) == 1 && v->tNbAffectes[i] == 0) signalerViolation(&v->rapport, VIOLATION_SANS_ETUDIANT, o->tRef[i]);
+        if (v->tNbAffectes[i] > 1) signalerViolation(&v->rapport, VIOLATION_DOUBLE_AFFECTATION, o->tRef[i]);
+
+        nbCandidats = 0;
+        for (int c = 0; c < 3; c++) {
+            if (tCol[c][i] == 0) continue; // Emplacement vide
+            nbCandidats++;
+            if (indiceEtudiant(v->index, tCol[c][i]) == -1) signalerViolation(&v->rapport, VIOLATION_CANDIDAT_INCONNU, tCol[c][i]);
+        }
+        if (candidOffre(o, i) != nbCandidats) signalerViolation(&v->rapport, VIOLATION_NB_CANDIDATS, o->tRef[i]);
+    }
+    return NULL;
+}
+
+/**
+ * \brief Vérifie les listes d'attente : offres qui peuvent en avoir, étudiants connus, sans stage et présents une seule fois.
+ * 
+ * Les files sont courtes : elles sont vérifiées par le fil appelant.
+ * 
+ * \param s Stockage à vérifier.
+ * \param index Index des étudiants.
+ * \param r Rapport à compléter.
+ */
+void verifierAttentes(Stockage *s, IndexEtudiants *index, Rapport *r) {
+    Attentes *a = &s->attentes;
+    Offres *o = &s->offres;
+    int ref, etu, sorte, pos, trouve, j, rang;
+
+    for (int f = 0; f < a->nbFiles; f++) {
+        if (a->tNb[f] == 0) continue; // File vidée
+        ref = a->tRef[f];
+        sorte = violationFile(o, ref, 0);
+        if (sorte != -1) signalerViolation(r, sorte, ref);
+        pos = rechercheDichoRef(o->tRef, o->tlog, ref, &trouve);
+
+        rang = 0;
+        for (int m = a->tTete[f]; m != -1; m = a->tSuivant[m]) {
+            etu = a->tEtu[m];
+            j = indiceEtudiant(index, etu);
+            if (j == -1 || s->etudiants.tRefStage[j] != -1) signalerViolation(r, VIOLATION_ATTENTE_ETUDIANT, etu);
+            if (rangAttente(a, ref, etu) != rang || (trouve == 1 && (o->tEtu1[pos] == etu || o->tEtu2[pos] == etu || o->tEtu3[pos] == etu))) {
+                signalerViolation(r, VIOLATION_ATTENTE_DOUBLE, etu); // Première place dans la file ailleurs qu'ici : doublon
+            }
+            rang++;
+        }
+    }
+}
+
+/**
+ * \brief Vérifie des tranches en parallèle, un fil par tranche (le fil appelant prend la première).
+ * 
+ * \param tTranches[] Tranches à vérifier.
+ * \param nbFils Nombre de tranches.
+ * \param verifier Fonction de vérification d'une tranche.
+ */
+void lancerVerification(Verification tTranches[], int nbFils, void *(*verifier)(void *)) {
+    pthread_t tFils[NB_FILS_MAX];
+
+    for (int k = 1; k < nbFils; k++) {
+        if (pthread_create(&tFils[k], NULL, verifier, &tTranches[k]) != 0) {
+            verifier(&tTranches[k]); // Pas de fil disponible : vérification sur place
+            tFils[k] = pthread_self();
+        }
+    }
+    verifier(&tTranches[0]);
+    for (int k = 1; k < nbFils; k++) {
+        if (!pthread_equal(tFils[k], pthread_self())) pthread_join(tFils[k], NULL);
+    }
+}
+
+/**
+ * \brief Vérifie la cohérence des offres et des étudiants chargés, en parallèle.
+ * 
+ * Les jointures passent par les index triés : la recherche dichotomique sur les
+ * références pour les stages des étudiants, les numéros d'étudiants triés pour
+ * les candidats. Les étudiants sont vérifiés d'abord, puis les offres, qui ont
+ * besoin du nombre d'étudiants affectés à chacune, puis les listes d'attente.
+ * 
+ * \param s Stockage à vérifier.
+ * \param r Rapport rempli avec les violations trouvées.
+ * \return Le nombre total de violations, -1 en cas d'erreur d'allocation.
+ */
+long verifierDonnees(Stockage *s, Rapport *r) {
+    Verification tTranches[NB_FILS_MAX];
+    IndexEtudiants index;
+    int *tNbAffectes, nbFils, plusGrand, sorte;
+    long nb = sysconf(_SC_NPROCESSORS_ONLN), total = 0;
+
+    memset(r, 0, sizeof(Rapport));
+    tNbAffectes = (int *)calloc(s->offres.tlog + 1, sizeof(int));
+    if (tNbAffectes == NULL || indexerEtudiants(&index, s->etudiants.tNumEtu, s->etudiants.tlog) == -1) {
+        free(tNbAffectes);
+        return -1; // Problème d'allocation
+    }
+
+    plusGrand = s->offres.tlog > s->etudiants.tlog ? s->offres.tlog : s->etudiants.tlog;
+    if (nb < 1) nb = 1;
+    if (nb > NB_FILS_MAX) nb = NB_FILS_MAX;
+    if (plusGrand / TRANCHE_VERIF_MIN < nb) nb = plusGrand / TRANCHE_VERIF_MIN;
+    if (nb < 1) nb = 1;
+    nbFils = (int)nb;
+
+    for (int k = 0; k < nbFils; k++) {
+        tTranches[k].s = s;
+        tTranches[k].index = &index;
+        tTranches[k].tNbAffectes = tNbAffectes;
+        memset(&tTranches[k].rapport, 0, sizeof(Rapport));
+        tTranches[k].debut = (int)((long)s->etudiants.tlog * k / nbFils);
+        tTranches[k].fin = (int)((long)s->etudiants.tlog * (k + 1) / nbFils);
+    }
+    lancerVerification(tTranches, nbFils, verifierTrancheEtudiants);
+
+    for (int k = 0; k < nbFils; k++) {
+        tTranches[k].debut = (int)((long)s->offres.tlog * k / nbFils);
+        tTranches[k].fin = (int)((long)s->offres.tlog * (k + 1) / nbFils);
+    }
+    lancerVerification(tTranches, nbFils, verifierTrancheOffres);
+
+    // Fusion dans l'ordre des tranches : les exemples gardés sont les premiers des tableaux
+    for (int k = 0; k < nbFils; k++) {
+        for (sorte = 0; sorte < NB_VIOLATIONS; sorte++) {
+            for (long e = 0; e < tTranches[k].rapport.tNb[sorte] && e < NB_EXEMPLES; e++) {
+                if (r->tNb[sorte] + e < NB_EXEMPLES) r->tExemples[sorte][r->tNb[sorte] + e] = tTranches[k].rapport.tExemples[sorte][e];
+            }
+            r->tNb[sorte] += tTranches[k].rapport.tNb[sorte];
+        }
+    }
+    verifierAttentes(s, &index, r);
+    for (sorte = 0; sorte < NB_VIOLATIONS; sorte++) total += r->tNb[sorte];
+
+    libererIndex(&index);
+    free(tNbAffectes);
+    return total;
+}
+
+/**
+ * \brief Relève les départements d'un manifeste et la taille totale de leurs fichiers.
+ * 
+ * \param flot Manifeste ouvert en lecture.
+ * \param dossier Dossier des données (les départements sont dans son sous-dossier "offres").
+ * \param tDpts Tableau alloué et rempli avec les départements (à libérer avec free).
+ * \param tailleOffres Taille totale des fichiers des départements.
+ * \return Le nombre de départements, -1 en cas d'erreur d'allocation.
+ */
+int lireDepartementsManifeste(FILE *flot, const char *dossier, int **tDpts, long *tailleOffres) {
+    char chemin[PATH_MAX];
+    struct stat infos;
+    Shard sh;
+    int *nouveau, nb = 0, tmax = 0;
+
+    *tDpts = NULL;
+    *tailleOffres = 0;
+    while (lireLigneManifeste(flot, &sh) == 1) {
+        if (nb == tmax) {
+            tmax = tmax == 0 ? 16 : tmax * 2;
+            nouveau = (int *)realloc(*tDpts, tmax * sizeof(int));
+            if (nouveau == NULL) {
+                free(*tDpts);
+                *tDpts = NULL;
+                return -1; // Problème d'allocation
+            }
+            *tDpts = nouveau;
+        }
+        (*tDpts)[nb++] = sh.dpt;
+        snprintf(chemin, sizeof(chemin), "%s/offres/%d.don", dossier, sh.dpt);
+        if (stat(chemin, &infos) == 0) *tailleOffres += infos.st_size;
+    }
+    return nb;
+}
+
+/**
+ * \brief Crée un stockage à la taille des fichiers d'un dossier et y charge les offres et les étudiants.
+ * 
+ * Si le dossier contient "offres/manifeste.don", les offres sont lues dans les
+ * fichiers des départements du manifeste ; sinon dans "offrestage.don". Le dossier
+ * doit contenir "etudiants.don" ; "attente.don" est lu s'il existe. Les offres
+ * sont triées par référence.
+ * 
+ * \param s Stockage à créer (à libérer avec libererStockage si le chargement a réussi).
+ * \param dossier Dossier contenant les fichiers.
+ * \param margeOffres Places réservées en plus pour des offres ajoutées après le chargement.
+ * \return 1 si tout s'est bien passé, -1 erreur sur les offres, -2 erreur sur les étudiants, -3 en cas d'erreur d'allocation.
+ */
+int chargerDossier(Stockage *s, const char *dossier, int margeOffres) {
+    char cheminOffres[PATH_MAX], cheminEtudiants[PATH_MAX], cheminAttente[PATH_MAX];
+    struct stat infoOffres, infoEtudiants;
+    Offres *o = &s->offres;
+    Etudiants *e = &s->etudiants;
+    FILE *flot;
+    int *tDpts = NULL, nbDpts = -1, code = 1; // nbDpts : -1 si les offres ne sont pas découpées
+    long tailleOffres;
+
+    snprintf(cheminOffres, sizeof(cheminOffres), "%s/offres/manifeste.don", dossier);
+    flot = fopen(cheminOffres, "r");
+    if (flot != NULL) { // Offres découpées par département
+        nbDpts = lireDepartementsManifeste(flot, dossier, &tDpts, &tailleOffres);
+        fclose(flot);
+        if (nbDpts == -1) return -3;
+    }
+    else {
+        snprintf(cheminOffres, sizeof(cheminOffres), "%s/offrestage.don", dossier);
+        if (stat(cheminOffres, &infoOffres) == -1) return -1;
+        tailleOffres = infoOffres.st_size;
+    }
+    snprintf(cheminEtudiants, sizeof(cheminEtudiants), "%s/etudiants.don", dossier);
+    snprintf(cheminAttente, sizeof(cheminAttente), "%s/attente.don", dossier);
+    if (stat(cheminEtudiants, &infoEtudiants) == -1) {
+        free(tDpts);
+        return -2;
+    }
+
+    // Un enregistrement occupe au moins 4 octets : capacités suffisantes pour tous les fichiers
+    if (creerStockage(s, (int)(tailleOffres / 4 + 1) + margeOffres, (int)(infoEtudiants.st_size / 4 + 1)) == -1) {
+        free(tDpts);
+        return -3;
+    }
+
+    if (nbDpts == -1) code = lireFichierOffres(cheminOffres, o);
+    for (int i = 0; i < nbDpts && code == 1; i++) {
+        snprintf(cheminOffres, sizeof(cheminOffres), "%s/offres/%d.don", dossier, tDpts[i]);
+        if (stat(cheminOffres, &infoOffres) == -1) continue; // Un fichier absent est un département vide
+        code = lireFichierOffres(cheminOffres, o);
+    }
+    free(tDpts);
+    if (code != 1) {
+        libererStockage(s);
+        return -1;
+    }
+    if (trierOffres(o) == -1) {
+        libererStockage(s);
+        return -3;
+    }
+    if (lireFichierEtudiants(cheminEtudiants, e) < 0) {
+        libererStockage(s);
+        return -2;
+    }
+    if (lireFichierAttente(cheminAttente, s, 1) == -1) {
+        libererStockage(s);
+        return -3;
+    }
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Écrit les changements entre deux versions des offres, par fusion des références triées.
+ * 
+ * Lignes écrites, une par changement :
+ * - "AJOUT REF DPT" et "SUPPR REF" : offre ajoutée ou supprimée ;
+ * - "DPT REF ANCIEN NOUVEAU" : département modifié ;
+ * - "POURVU REF" et "LIBERE REF" : offre pourvue ou de nouveau libre ;
+ * - "CANDIDATS REF ETU1 ETU2 ETU3" : nouveaux candidats (0 : emplacement vide).
+ * 
+ * Une offre ajoutée est comparée à une offre vide : elle peut donc être suivie de
+ * lignes "POURVU" ou "CANDIDATS".
+ * 
+ * \param a Offres de l'ancienne version, triées par référence.
+ * \param b Offres de la nouvelle version, triées par référence.
+ * \param flot Flot où écrire les changements.
+ * \return Le nombre de changements écrits.
+ */
+long comparerOffres(Offres *a, Offres *b, FILE *flot) {
+    int i = 0, j = 0, tA[7], tB[7];
+    long nb = 0;
+
+    while (i < a->tlog || j < b->tlog) {
+        if (j >= b->tlog || (i < a->tlog && a->tRef[i] < b->tRef[j])) {
+            fprintf(flot, "SUPPR %d\n", a->tRef[i]);
+            nb++;
+            i++;
+            continue;
+        }
+
+        lireLigneOffre(b, j, tB);
+        if (i < a->tlog && a->tRef[i] == b->tRef[j]) {
+            lireLigneOffre(a, i, tA);
+            i++;
+        }
+        else { // Offre ajoutée : comparée à une offre vide
+            fprintf(flot, "AJOUT %d %d\n", tB[0], tB[1]);
+            nb++;
+            memset(tA, 0, sizeof(tA));
+            tA[1] = tB[1];
+        }
+
+        if (tB[1] != tA[1]) {
+            fprintf(flot, "DPT %d %d %d\n", tB[0], tA[1], tB[1]);
+            nb++;
+        }
+        if (tB[2] != tA[2]) {
+            fprintf(flot, tB[2] == 1 ? "POURVU %d\n" : "LIBERE %d\n", tB[0]);
+            nb++;
+        }
+        if (memcmp(tB + 3, tA + 3, 4 * sizeof(int)) != 0) {
+            fprintf(flot, "CANDIDATS %d %d %d %d\n", tB[0], tB[4], tB[5], tB[6]);
+            nb++;
+        }
+        j++;
+    }
+    return nb;
+}
+
+/**
+ * \brief Écrit les changements entre deux versions des étudiants, par fusion des numéros triés.
+ * 
+ * Lignes écrites, une par changement :
+ * - "ARRIVEE NUM REF NOTE" et "DEPART NUM" : étudiant ajouté ou retiré ;
+ * - "STAGE NUM ANCIEN NOUVEAU" : stage affecté, changé ou retiré (-1 : aucun) ;
+ * - "NOTE NUM ANCIENNE NOUVELLE" : moyenne modifiée.
+ * 
+ * \param a Étudiants de l'ancienne version.
+ * \param b Étudiants de la nouvelle version.
+ * \param flot Flot où écrire les changements.
+ * \return Le nombre de changements écrits, -1 en cas d'erreur d'allocation.
+ */
+long comparerEtudiants(Etudiants *a, Etudiants *b, FILE *flot) {
+    IndexEtudiants ia, ib;
+    int i = 0, j = 0, numA, numB, pa, pb;
+    long nb = 0;
+
+    // Numéros triés des deux versions
+    if (indexerEtudiants(&ia, a->tNumEtu, a->tlog) == -1) return -1;
+    if (indexerEtudiants(&ib, b->tNumEtu, b->tlog) == -1) {
+        libererIndex(&ia);
+        return -1; // Problème d'allocation
+    }
+
+    while (i < a->tlog || j < b->tlog) {
+        numA = i < a->tlog ? (int)(ia.tCles[i] >> 32) : 0;
+        numB = j < b->tlog ? (int)(ib.tCles[j] >> 32) : 0;
+        pa = i < a->tlog ? (int)(ia.tCles[i] & 0xFFFFFFFF) : -1;
+        pb = j < b->tlog ? (int)(ib.tCles[j] & 0xFFFFFFFF) : -1;
+
+        if (j >= b->tlog || (i < a->tlog && numA < numB)) {
+            fprintf(flot, "DEPART %d\n", numA);
+            nb++;
+            i++;
+        }
+        else if (i >= a->tlog || numB < numA) {
+            fprintf(flot, "ARRIVEE %d %d %.2f\n", numB, b->tRefStage[pb], noteEtudiant(b, pb));
+            nb++;
+            j++;
+        }
+        else {
+            if (a->tRefStage[pa] != b->tRefStage[pb]) {
+                fprintf(flot, "STAGE %d %d %d\n", numB, a->tRefStage[pa], b->tRefStage[pb]);
+                nb++;
+            }
+            if (noteEtudiant(a, pa) != noteEtudiant(b, pb)) {
+                fprintf(flot, "NOTE %d %.2f %.2f\n", numB, noteEtudiant(a, pa), noteEtudiant(b, pb));
+                nb++;
+            }
+            i++;
+            j++;
+        }
+    }
+
+    libererIndex(&ia);
+    libererIndex(&ib);
+    return nb;
+}
+
+/**
+ * \brief Indique si deux files d'attente contiennent les mêmes étudiants dans le même ordre.
+ * 
+ * \param a Listes d'attente de la première version.
+ * \param fa File dans a (-1 : aucune file).
+ * \param b Listes d'attente de la seconde version.
+ * \param fb File dans b (-1 : aucune file).
+ * \return 1 si les files sont identiques (une file absente est vide), 0 sinon.
+ */
+int memeFile(Attentes *a, int fa, Attentes *b, int fb) {
+    int ma = fa == -1 ? -1 : a->tTete[fa], mb = fb == -1 ? -1 : b->tTete[fb];
+
+    while (ma != -1 && mb != -1) {
+        if (a->tEtu[ma] != b->tEtu[mb]) return 0;
+        ma = a->tSuivant[ma];
+        mb = b->tSuivant[mb];
+    }
+    return ma == -1 && mb == -1;
+}
+
+/**
+ * \brief Écrit les changements entre deux versions des listes d'attente, par fusion des références triées.
+ * 
+ * Une ligne "ATTENTE REF NB ETU..." donne la nouvelle file de chaque offre dont la
+ * file a changé (NB vaut 0 si elle a été vidée).
+ * 
+ * \param a Listes d'attente de l'ancienne version.
+ * \param b Listes d'attente de la nouvelle version.
+ * \param flot Flot où écrire les changements.
+ * \return Le nombre de changements écrits.
+ */
+long comparerAttentes(Attentes *a, Attentes *b, FILE *flot) {
+    int i = 0, j = 0, ref, fa, fb;
+    long nb = 0;
+
+    while (i < a->nbFiles || j < b->nbFiles) {
+        if (j >= b->nbFiles || (i < a->nbFiles && a->tRef[i] < b->tRef[j])) {
+            ref = a->tRef[i];
+            fa = i++;
+            fb = -1;
+        }
+        else if (i >= a->nbFiles || b->tRef[j] < a->tRef[i]) {
+            ref = b->tRef[j];
+            fa = -1;
+            fb = j++;
+        }
+        else {
+            ref = a->tRef[i];
+            fa = i++;
+            fb = j++;
+        }
+        if (memeFile(a, fa, b, fb) == 1) continue;
+
+        fprintf(flot, "ATTENTE %d %d", ref, fb == -1 ? 0 : b->tNb[fb]);
+        for (int m = fb == -1 ? -1 : b->tTete[fb]; m != -1; m = b->tSuivant[m]) fprintf(flot, " %d", b->tEtu[m]);
+        fprintf(flot, "\n");
+        nb++;
+    }
+    return nb;
+}
+
+/**
+ * \brief Charge deux versions des données et écrit au fil de l'eau les changements de l'une à l'autre.
+ * 
+ * \param dossierA Dossier de l'ancienne version.
+ * \param dossierB Dossier de la nouvelle version.
+ * \param flot Flot où écrire les changements (voir comparerOffres, comparerEtudiants et comparerAttentes).
+ * \return Le nombre de changements, -1 si l'ancienne version est illisible, -2 si la nouvelle l'est, -3 en cas d'erreur d'allocation.
+ */
+long comparerDossiers(const char *dossierA, const char *dossierB, FILE *flot) {
+    Stockage a, b;
+    long nbOffres, nbEtudiants, nbAttentes;
+    int code;
+
+    code = chargerDossier(&a, dossierA, 0);
+    if (code != 1) return code == -3 ? -3 : -1;
+    code = chargerDossier(&b, dossierB, 0);
+    if (code != 1) {
+        libererStockage(&a);
+        return code == -3 ? -3 : -2;
+    }
+
+    nbOffres = comparerOffres(&a.offres, &b.offres, flot);
+    nbEtudiants = comparerEtudiants(&a.etudiants, &b.etudiants, flot);
+    nbAttentes = comparerAttentes(&a.attentes, &b.attentes, flot);
+    libererStockage(&a);
+    libererStockage(&b);
+    if (nbEtudiants == -1) return -3;
+    return nbOffres + nbEtudiants + nbAttentes;
+}
+
+/**
+ * \brief Initialise des listes d'attente vides.
+ * 
+ * \param a Listes d'attente (à libérer avec libererAttentes).
+ */
+void attentesInit(Attentes *a) {
+    memset(a, 0, sizeof(Attentes));
+    a->libre = -1;
+}
+
+/**
+ * \brief Libère la mémoire des listes d'attente.
+ * 
+ * \param a Listes d'attente à libérer.
+ */
+void libererAttentes(Attentes *a) {
+    free(a->tRef);
+    free(a->tTete);
+    free(a->tQueue);
+    free(a->tNb);
+    free(a->tEtu);
+    free(a->tSuivant);
+    attentesInit(a);
+}
+
+/**
+ * \brief Recherche la file d'une offre par dichotomie, et la crée au besoin.
+ * 
+ * \param a Listes d'attente.
+ * \param ref Référence de l'offre.
+ * \param creer 1 pour créer une file vide si l'offre n'en a pas, 0 sinon.
+ * \return La position de la file, -1 si l'offre n'en a pas (ou en cas d'erreur d'allocation).
+ */
+int fileAttente(Attentes *a, int ref, int creer) {
+    int deb = 0, fin = a->nbFiles - 1, mil, tmax;
+    int *tRef, *tTete, *tQueue, *tNb;
+
+    while (deb <= fin) {
+        mil = (deb + fin) / 2;
+        if (a->tRef[mil] == ref) return mil;
+        if (a->tRef[mil] < ref) deb = mil + 1;
+        else fin = mil - 1;
+    }
+    if (creer == 0) return -1;
+
+    if (a->nbFiles == a->tmaxFiles) {
+        tmax = a->tmaxFiles == 0 ? 16 : a->tmaxFiles * 2;
+        tRef = (int *)realloc(a->tRef, tmax * sizeof(int));
+        if (tRef != NULL) a->tRef = tRef;
+        tTete = (int *)realloc(a->tTete, tmax * sizeof(int));
+        if (tTete != NULL) a->tTete = tTete;
+        tQueue = (int *)realloc(a->tQueue, tmax * sizeof(int));
+        if (tQueue != NULL) a->tQueue = tQueue;
+        tNb = (int *)realloc(a->tNb, tmax * sizeof(int));
+        if (tNb != NULL) a->tNb = tNb;
+        if (tRef == NULL || tTete == NULL || tQueue == NULL || tNb == NULL) return -1; // Problème d'allocation
+        a->tmaxFiles = tmax;
+    }
+
+    for (int i = a->nbFiles; i > deb; i--) { // deb : place de la nouvelle file
+        a->tRef[i] = a->tRef[i - 1];
+        a->tTete[i] = a->tTete[i - 1];
+        a->tQueue[i] = a->tQueue[i - 1];
+        a->tNb[i] = a->tNb[i - 1];
+    }
+    a->tRef[deb] = ref;
+    a->tTete[deb] = -1;
+    a->tQueue[deb] = -1;
+    a->tNb[deb] = 0;
+    a->nbFiles++;
+    return deb;
+}
+
+/**
+ * \brief Prend un maillon dans la liste libre, en agrandissant la réserve si elle est vide.
+ * 
+ * \param a Listes d'attente.
+ * \return Le maillon pris, -1 en cas d'erreur d'allocation.
+ */
+int prendreMaillon(Attentes *a) {
+    int m, tmax, *tEtu, *tSuivant;
+
+    if (a->libre == -1) {
+        tmax = a->tmaxMaillons == 0 ? 64 : a->tmaxMaillons * 2;
+        tEtu = (int *)realloc(a->tEtu, tmax * sizeof(int));
+        if (tEtu != NULL) a->tEtu = tEtu;
+        tSuivant = (int *)realloc(a->tSuivant, tmax * sizeof(int));
+        if (tSuivant != NULL) a->tSuivant = tSuivant;
+        if (tEtu == NULL || tSuivant == NULL) return -1; // Problème d'allocation
+
+        for (m = a->tmaxMaillons; m < tmax - 1; m++) a->tSuivant[m] = m + 1; // Nouveaux maillons libres
+        a->tSuivant[tmax - 1] = -1;
+        a->libre = a->tmaxMaillons;
+        a->tmaxMaillons = tmax;
+    }
+    m = a->libre;
+    a->libre = a->tSuivant[m];
+    return m;
+}
+
+/**
+ * \brief Ajoute un étudiant dans la file d'une offre.
+ * 
+ * \param a Listes d'attente.
+ * \param ref Référence de l'offre.
+ * \param etu Numéro de l'étudiant.
+ * \param rang Rang de l'étudiant dans la file (0 : en tête), -1 pour l'ajouter en queue.
+ * \return Le rang de l'étudiant dans la file, -1 en cas d'erreur d'allocation.
+ */
+int insererAttente(Attentes *a, int ref, int etu, int rang) {
+    int f = fileAttente(a, ref, 1), m, prec;
+
+    if (f == -1) return -1; // Problème d'allocation
+    m = prendreMaillon(a);
+    if (m == -1) return -1;
+    a->tEtu[m] = etu;
+    if (rang == -1 || rang > a->tNb[f]) rang = a->tNb[f];
+
+    if (rang == a->tNb[f]) { // En queue : O(1)
+        a->tSuivant[m] = -1;
+        if (a->tQueue[f] == -1) a->tTete[f] = m;
+        else a->tSuivant[a->tQueue[f]] = m;
+        a->tQueue[f] = m;
+    }
+    else if (rang == 0) { // En tête : O(1)
+        a->tSuivant[m] = a->tTete[f];
+        a->tTete[f] = m;
+    }
+    else {
+        prec = a->tTete[f];
+        for (int r = 1; r < rang; r++) prec = a->tSuivant[prec];
+        a->tSuivant[m] = a->tSuivant[prec];
+        a->tSuivant[prec] = m;
+    }
+    a->tNb[f]++;
+    return rang;
+}
+
+/**
+ * \brief Retire l'étudiant d'un rang donné de la file d'une offre et rend son maillon à la liste libre.
+ * 
+ * \param a Listes d'attente.
+ * \param ref Référence de l'offre.
+ * \param rang Rang de l'étudiant à retirer (0 : la tête, en O(1)).
+ * \return Le numéro de l'étudiant retiré, 0 si la file n'a pas ce rang.
+ */
+int retirerAttente(Attentes *a, int ref, int rang) {
+    int f = fileAttente(a, ref, 0), m, prec = -1, etu;
+
+    if (f == -1 || rang < 0 || rang >= a->tNb[f]) return 0;
+    m = a->tTete[f];
+    for (int r = 0; r < rang; r++) {
+        prec = m;
+        m = a->tSuivant[m];
+    }
+
+    if (prec == -1) a->tTete[f] = a->tSuivant[m];
+    else a->tSuivant[prec] = a->tSuivant[m];
+    if (a->tQueue[f] == m) a->tQueue[f] = prec;
+    a->tNb[f]--;
+
+    etu = a->tEtu[m];
+    a->tSuivant[m] = a->libre;
+    a->libre = m;
+    return etu;
+}
+
+/**
+ * \brief Donne le rang d'un étudiant dans la file d'une offre.
+ * 
+ * \param a Listes d'attente.
+ * \param ref Référence de l'offre.
+ * \param etu Numéro de l'étudiant.
+ * \return Le rang de l'étudiant (0 : en tête), -1 s'il n'attend pas cette offre.
+ */
+int rangAttente(Attentes *a, int ref, int etu) {
+    int f = fileAttente(a, ref, 0), rang = 0;
+
+    if (f == -1) return -1;
+    for (int m = a->tTete[f]; m != -1; m = a->tSuivant[m]) {
+        if (a->tEtu[m] == etu) return rang;
+        rang++;
+    }
+    return -1;
+}
+
+/**
+ * \brief Donne les étudiants qui attendent une offre, dans l'ordre de la file.
+ * 
+ * \param a Listes d'attente.
+ * \param ref Référence de l'offre.
+ * \param tEtu[] Tableau rempli avec les numéros des étudiants (au plus max).
+ * \param max Taille du tableau.
+ * \return La longueur de la file (qui peut dépasser max).
+ */
+int listeAttente(Attentes *a, int ref, int tEtu[], int max) {
+    int f = fileAttente(a, ref, 0), nb = 0;
+
+    if (f == -1) return 0;
+    for (int m = a->tTete[f]; m != -1 && nb < max; m = a->tSuivant[m]) tEtu[nb++] = a->tEtu[m];
+    return a->tNb[f];
+}
+
+/**
+ * \brief Met les listes d'attente à plat : pour chaque file non vide, REF, NB puis les NB étudiants.
+ * 
+ * \param a Listes d'attente.
+ * \param tAttente Tableau alloué et rempli (à libérer avec free).
+ * \param lgAttente Longueur du tableau.
+ * \return 1 si le tableau a été rempli, -1 en cas d'erreur d'allocation.
+ */
+int aplatirAttentes(Attentes *a, int **tAttente, int *lgAttente) {
+    int lg = 0;
+
+    for (int f = 0; f < a->nbFiles; f++) {
+        if (a->tNb[f] > 0) lg += 2 + a->tNb[f];
+    }
+    *tAttente = (int *)malloc((lg + 1) * sizeof(int));
+    if (*tAttente == NULL) return -1; // Problème d'allocation
+
+    *lgAttente = 0;
+    for (int f = 0; f < a->nbFiles; f++) {
+        if (a->tNb[f] == 0) continue;
+        (*tAttente)[(*lgAttente)++] = a->tRef[f];
+        (*tAttente)[(*lgAttente)++] = a->tNb[f];
+        for (int m = a->tTete[f]; m != -1; m = a->tSuivant[m]) (*tAttente)[(*lgAttente)++] = a->tEtu[m];
+    }
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Ajoute aux listes d'attente les files d'un tableau mis à plat (voir aplatirAttentes).
+ * 
+ * \param a Listes d'attente.
+ * \param tAttente[] Files mises à plat.
+ * \param lgAttente Longueur du tableau.
+ * \return 1 si les files ont été ajoutées, -1 en cas d'erreur d'allocation.
+ */
+int chargerAttentesTableau(Attentes *a, int tAttente[], int lgAttente) {
+    int i = 0, ref, nb;
+
+    while (i + 1 < lgAttente) {
+        ref = tAttente[i];
+        nb = tAttente[i + 1];
+        i += 2;
+        for (int k = 0; k < nb && i < lgAttente; k++) {
+            if (insererAttente(a, ref, tAttente[i++], -1) == -1) return -1;
+        }
+    }
+    return 1; // Fonction réussi
+}
+
+/**
+ * \brief Indique si une offre peut avoir une liste d'attente : elle existe, n'est pas pourvue et a ses 3 candidats.
+ * 
+ * \param o Offres chargées.
+ * \param ref Référence de l'offre.
+ * \param complet 1 si toutes les offres sont chargées, 0 si des départements peuvent manquer (voir offreHorsMemoire).
+ * \return -1 si la file est permise (ou l'offre pas encore chargée), VIOLATION_ATTENTE_OFFRE ou VIOLATION_ATTENTE_PLACE sinon.
+ */
+int violationFile(Offres *o, int ref, int complet) {
+    int pos, trouve;
+
+    pos = rechercheDichoRef(o->tRef, o->tlog, ref, &trouve);
+    if (trouve == 0) return complet == 0 && offreHorsMemoire(ref) == 1 ? -1 : VIOLATION_ATTENTE_OFFRE;
+    if (pourvuOffre(o, pos) == 1) return VIOLATION_ATTENTE_OFFRE;
+    if (candidOffre(o, pos) < 3) return VIOLATION_ATTENTE_PLACE;
+    return -1;
+}
+
+/**
+ * \brief Lit les listes d'attente d'un fichier (une ligne "REF NB ETU..." par offre).
+ * 
+ * Les offres doivent être chargées. Une file est ignorée si son offre n'existe
+ * pas, est pourvue ou a encore des places (voir violationFile) ; un étudiant est
+ * ignoré s'il est déjà dans la file ou candidat de l'offre.
+ * 
+ * \param chemin Chemin du fichier à lire.
+ * \param s Stockage dont les listes d'attente sont complétées.
+ * \param complet 1 si toutes les offres sont chargées, 0 si des départements peuvent manquer.
+ * \return 1 si tout s'est bien passé (un fichier absent ne contient aucune file), 2 si des files ou des étudiants
+ * ont été ignorés, -1 en cas d'erreur d'allocation.
+ */
+int lireFichierAttente(const char *chemin, Stockage *s, int complet) {
+    Offres *o = &s->offres;
+    FILE *flot;
+    int ref, nb, etu, valide, pos, trouve, code = 1;
+
+    flot = fopen(chemin, "r");
+    if (flot == NULL) return 1; // Aucune liste d'attente
+    while (code != -1 && fscanf(flot, "%d%d", &ref, &nb) == 2) {
+        valide = violationFile(o, ref, complet) == -1;
+        if (valide == 0) code = 2;
+        pos = rechercheDichoRef(o->tRef, o->tlog, ref, &trouve);
+        for (int k = 0; k < nb && fscanf(flot, "%d", &etu) == 1; k++) {
+            if (valide == 0) continue; // File lue jusqu'au bout, sans être gardée
+            if (rangAttente(&s->attentes, ref, etu) != -1 || (trouve == 1 && (o->tEtu1[pos] == etu || o->tEtu2[pos] == etu || o->tEtu3[pos] == etu))) {
+                code = 2;
+                continue;
+            }
+            if (insererAttente(&s->attentes, ref, etu, -1) == -1) code = -1;
+        }
+    }
+    fclose(flot);
+    return code;
+}
+
+/**
+ * \brief Écrit les listes d'attente dans "attente.don".
+ * 
+ * \param tAttente[] Files mises à plat (voir aplatirAttentes).
+ * \param lgAttente Longueur du tableau.
+ * \return 1 si le fichier a été écrit, -1 en cas d'erreur.
+ */
+int ecrireFichierAttente(int tAttente[], int lgAttente) {
+    FILE *flot;
+    int i = 0, nb;
+
+    flot = ouvrirTemporaire(FICHIER_ATTENTE);
+    if (flot == NULL) return -1;
+    while (i + 1 < lgAttente) {
+        nb = tAttente[i + 1];
+        fprintf(flot, "%d %d", tAttente[i], nb);
+        i += 2;
+        for (int k = 0; k < nb && i < lgAttente; k++) fprintf(flot, " %d", tAttente[i++]);
+        fprintf(flot, "\n");
+    }
+    return publierTemporaire(flot, FICHIER_ATTENTE, !ferror(flot));
+}
+
+/**
+ * \brief Enregistre dans le journal un ajout ou un retrait dans une liste d'attente.
+ * 
+ * \param type JOURNAL_ATTENTE_AJOUT ou JOURNAL_ATTENTE_RETRAIT.
+ * \param ref Référence de l'offre.
+ * \param etu Numéro de l'étudiant.
+ * \param rang Rang de l'étudiant dans la file.
+ */
+void journaliserAttente(int type, int ref, int etu, int rang) {
+    EntreeJournal entree;
+    int tAvant[7] = {ref, etu, rang};
+
+    marquerModification();
+    noterModification(1, ref, type == JOURNAL_ATTENTE_AJOUT ? MODIF_ATTENTE_AJOUT : MODIF_ATTENTE_RETRAIT, tAvant, 0);
+    if (transactionActive == 0) return;
+
+    entree.type = type;
+    entree.pos = 0;
+    entree.tLigne[0] = ref;
+    entree.tLigne[1] = etu;
+    entree.tLigne[2] = rang;
+    entree.note = 0;
+    journaliser(entree);
+}
+
+/**
+ * \brief Ajoute un étudiant en queue de la liste d'attente d'une offre complète.
+ * 
+ * \param s Stockage des données.
+ * \param ref Référence de l'offre.
+ * \param etu Numéro de l'étudiant.
+ * \return 2 si l'étudiant a été mis en attente, -4 s'il attend déjà cette offre, -7 en cas d'erreur d'allocation.
+ */
+int mettreEnAttente(Stockage *s, int ref, int etu) {
+    int rang;
+
+    if (rangAttente(&s->attentes, ref, etu) != -1) return -4; // Déjà en attente
+    rang = insererAttente(&s->attentes, ref, etu, -1);
+    if (rang == -1) return -7; // Problème d'allocation
+    journaliserAttente(JOURNAL_ATTENTE_AJOUT, ref, etu, rang);
+    emettreEvenement("ATTENTE %d %d", ref, etu);
+    return 2;
+}
+
+/**
+ * \brief Remplit les places libres d'une offre avec les premiers étudiants de sa liste d'attente.
+ * 
+ * Chaque place est remplie en O(1) : l'étudiant est pris en tête de file.
+ * 
+ * \param s Stockage des données.
+ * \param pos Position de l'offre.
+ */
+void promouvoirAttente(Stockage *s, int pos) {
+    Offres *o = &s->offres;
+    int ref = o->tRef[pos], f = fileAttente(&s->attentes, ref, 0), etu;
+
+    if (f == -1 || pourvuOffre(o, pos) == 1) return;
+    while (candidOffre(o, pos) < 3 && s->attentes.tNb[f] > 0) {
+        journaliserOffre(JOURNAL_MODIF, pos, o);
+        etu = retirerAttente(&s->attentes, ref, 0);
+        journaliserAttente(JOURNAL_ATTENTE_RETRAIT, ref, etu, 0);
+
+        if (o->tEtu1[pos] == 0) o->tEtu1[pos] = etu;
+        else if (o->tEtu2[pos] == 0) o->tEtu2[pos] = etu;
+        else o->tEtu3[pos] = etu;
+        fixerCandid(o, pos, candidOffre(o, pos) + 1);
+        emettreEvenement("CANDID %d %d", ref, etu);
+    }
+}
+
+/**
+ * \brief Vide la liste d'attente d'une offre (offre supprimée ou pourvue).
+ * 
+ * \param s Stockage des données.
+ * \param ref Référence de l'offre.
+ */
+void viderAttente(Stockage *s, int ref) {
+    int f = fileAttente(&s->attentes, ref, 0), etu;
+
+    if (f == -1) return;
+    while (s->attentes.tNb[f] > 0) {
+        etu = retirerAttente(&s->attentes, ref, 0);
+        journaliserAttente(JOURNAL_ATTENTE_RETRAIT, ref, etu, 0);
+    }
+}
+
+/**
+ * \brief Retire un étudiant de toutes les listes d'attente (il vient d'obtenir un stage).
+ * 
+ * Un étudiant n'apparaît qu'une fois par file : les têtes de file restent
+ * ainsi toujours des étudiants à promouvoir.
+ * 
+ * \param s Stockage des données.
+ * \param etu Numéro de l'étudiant.
+ */
+void oublierAttentes(Stockage *s, int etu) {
+    Attentes *a = &s->attentes;
+    int rang;
+
+    for (int f = 0; f < a->nbFiles; f++) {
+        rang = rangAttente(a, a->tRef[f], etu);
+        if (rang == -1) continue;
+        retirerAttente(a, a->tRef[f], rang);
+        journaliserAttente(JOURNAL_ATTENTE_RETRAIT, a->tRef[f], etu, rang);
+    }
+}
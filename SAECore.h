@@ -0,0 +1,492 @@
+/**
+ * \file SAECore.h
+ * \brief Déclarations du cœur de la gestion des stages (bibliothèque libsae).
+ *
+ * Les fonctions du cœur ne lisent rien au clavier et n'affichent rien : elles
+ * reçoivent leurs paramètres et rendent un résultat ou un code de retour.
+ *
+ * \authors MIOTTO Quentin, PICHOT-MOÏSE Mathéo
+ * \date 15 Octobre 2024
+ */
+#ifndef SAECORE_H
+#define SAECORE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/file.h>
+#include <signal.h>
+#include <errno.h>
+
+#define DOSSIER_DATA "DATA"
+#define FICHIER_OFFRES "DATA/offrestage.don"
+#define FICHIER_ETUDIANTS "DATA/etudiants.don"
+#define FICHIER_ATTENTE "DATA/attente.don" // Listes d'attente : "REF NB ETU..." par offre
+#define DOSSIER_SHARDS "DATA/offres" // Offres découpées : un fichier par département
+#define FICHIER_MANIFESTE "DATA/offres/manifeste.don" // Liste des départements découpés
+#define FICHIER_EVENEMENTS "DATA/evenements.log" // Flux des modifications (fichier ou tube FIFO)
+#define FICHIER_SEQUENCE "DATA/evenements.seq" // Dernier numéro d'événement écrit dans un tube FIFO
+#define FICHIER_VERROU "DATA/verrou" // Verrou consultatif (flock) partagé par les processus
+#define FICHIER_ESTAMPILLE "DATA/estampille.don" // Numéro de la version des fichiers, augmenté à chaque sauvegarde
+
+#define INTERVALLE_SAUVEGARDE 2 // Secondes entre deux sauvegardes automatiques
+#define MARGE_OFFRES 200 // Offres ajoutables pendant une session, en plus de celles des fichiers
+
+#define NB_FILS_MAX 16 // Nombre maximal de fils pour analyser un fichier
+#define TAILLE_MORCEAU_MIN (1 << 20) // Taille minimale d'un morceau analysé par un fil (octets)
+
+#define DPT_MIN SHRT_MIN // Plus petit département représentable (colonne sur 16 bits)
+#define DPT_MAX SHRT_MAX // Plus grand département représentable
+#define CANDID_MAX UCHAR_MAX // Plus grand nombre de candidats représentable (colonne sur 8 bits)
+#define MOTS_POURVU(n) (((n) + 63) / 64) // Mots de 64 bits de la colonne POURVU pour n offres
+
+/**
+ * \brief Colonnes des offres de stage.
+ *
+ * Les colonnes chaudes, lues par les parcours (listes, recherches, index des
+ * références), sont contiguës dans un même bloc ; les colonnes froides sont
+ * rangées à part dans un second bloc. POURVU tient sur un bit, CANDID sur un
+ * octet et DPT sur 16 bits : elles se lisent et s'écrivent par les accesseurs
+ * (pourvuOffre, fixerPourvu...), qui rendent et prennent des int.
+ */
+typedef struct {
+    unsigned long long *tBitsPourvu; // Colonnes chaudes : POURVU de l'offre i au bit i % 64 du mot i / 64
+    int *tRef;
+    unsigned char *tNbCandid;
+    int *tEtu1, *tEtu2, *tEtu3; // Colonnes froides
+    short *tNumDpt;
+    int tlog; // Nombre d'offres
+    int tmax; // Capacité des colonnes
+} Offres;
+
+/**
+ * \brief Colonnes des étudiants.
+ *
+ * La note finale est gardée en centièmes sur 16 bits (-100 : pas de note) ;
+ * elle se lit et s'écrit par noteEtudiant et fixerNote.
+ */
+typedef struct {
+    int *tNumEtu, *tRefStage;
+    short *tNote; // Note finale en centièmes
+    int tlog; // Nombre d'étudiants
+    int tmax; // Capacité des colonnes
+} Etudiants;
+
+/**
+ * \brief Listes d'attente des offres complètes, une file par offre.
+ *
+ * Les maillons de toutes les files sont pris dans une même réserve et chaînés par
+ * tSuivant ; les maillons rendus forment une liste libre, réutilisée avant
+ * d'agrandir la réserve. Les files sont repérées par la référence de leur offre.
+ */
+typedef struct {
+    int *tRef; // Références des offres qui ont une file (triées)
+    int *tTete, *tQueue; // Premier et dernier maillon de chaque file (-1 : file vide)
+    int *tNb; // Longueur de chaque file
+    int nbFiles, tmaxFiles;
+    int *tEtu; // Étudiant en attente dans chaque maillon
+    int *tSuivant; // Maillon suivant (-1 : fin de la file ou de la liste libre)
+    int libre; // Premier maillon libre (-1 : réserve pleine)
+    int tmaxMaillons;
+} Attentes;
+
+/**
+ * \brief Données du programme : propriétaire des colonnes des offres et des étudiants.
+ */
+typedef struct {
+    Offres offres;
+    Etudiants etudiants;
+    Attentes attentes;
+} Stockage;
+
+#define JOURNAL_AJOUT 1 // Offre insérée
+#define JOURNAL_SUPPR 2 // Offre supprimée
+#define JOURNAL_MODIF 3 // Offre modifiée
+#define JOURNAL_STAGE 4 // Stage d'un étudiant modifié
+#define JOURNAL_NOTE 5 // Note d'un étudiant modifiée
+#define JOURNAL_ATTENTE_AJOUT 6 // Étudiant ajouté à une liste d'attente
+#define JOURNAL_ATTENTE_RETRAIT 7 // Étudiant retiré d'une liste d'attente
+
+/**
+ * \brief Entrée du journal d'annulation : image d'une ligne avant sa modification.
+ */
+typedef struct {
+    int type; // Nature de la modification (JOURNAL_...)
+    int pos; // Position de la ligne modifiée
+    int tLigne[7]; // REF, DPT, POURVU, CANDID, ETU1, ETU2, ETU3 avant modification (ou REF STAGE de l'étudiant, ou REF, ETU, rang dans la liste d'attente)
+    float note; // Note avant modification
+} EntreeJournal;
+
+// Nature d'une modification notée pour la fusion des sauvegardes
+#define MODIF_LIGNE 1 // Offre modifiée ou supprimée
+#define MODIF_ABSENTE 2 // Offre ajoutée (absente avant la modification)
+#define MODIF_STAGE 3 // Stage d'un étudiant modifié
+#define MODIF_NOTE 4 // Note d'un étudiant modifiée
+#define MODIF_ATTENTE_AJOUT 5 // Étudiant ajouté à la liste d'attente d'une offre
+#define MODIF_ATTENTE_RETRAIT 6 // Étudiant retiré de la liste d'attente d'une offre
+
+/**
+ * \brief Ligne modifiée par la session depuis sa dernière sauvegarde, avec son image avant modification.
+ *
+ * Quand un autre processus a sauvegardé entre-temps, seuls les champs changés
+ * par la session sur ces lignes sont reportés sur la version des fichiers.
+ */
+typedef struct {
+    int offre; // 1 pour une offre, 0 pour un étudiant
+    int cle; // REF de l'offre, ou position de l'étudiant (les étudiants ne changent pas de place)
+    int version; // Version des données après la modification
+    int champ; // Nature de la modification (MODIF_...)
+    int tAvant[7]; // REF, DPT, POURVU, CANDID, ETU1, ETU2, ETU3 avant modification (ou REF STAGE de l'étudiant, ou REF, ETU, rang dans la liste d'attente)
+    float noteAvant; // Note de l'étudiant avant modification
+} Modification;
+
+/**
+ * \brief Copie figée des tableaux à une version donnée, partagée entre lecteurs.
+ *
+ * Un instantané n'est jamais modifié après sa création ; il est libéré quand
+ * le dernier lecteur qui l'a épinglé le relâche.
+ */
+typedef struct {
+    int version; // Version des données au moment de la copie
+    int nbLecteurs; // Lecteurs qui l'utilisent (+1 tant qu'il est l'instantané publié)
+    Offres offres; // Copie des offres (tmax = tlog)
+    Etudiants etudiants; // Copie des étudiants (tmax = tlog)
+    int *tAttente; // Listes d'attente à plat (voir aplatirAttentes)
+    int lgAttente;
+} Instantane;
+
+/**
+ * \brief Index des étudiants : numéros triés, chacun avec sa position dans les tableaux.
+ */
+typedef struct {
+    int tlog; // Nombre d'étudiants
+    long long *tCles; // (numéro << 32 | position) triés par numéro
+} IndexEtudiants;
+
+/**
+ * \brief Matrice creuse des candidatures : pour chaque offre, les positions de ses candidats.
+ *
+ * Les lignes sont rangées bout à bout (3 candidats au plus par offre) : la mémoire
+ * suit le nombre de candidatures, et non le produit offres × étudiants.
+ */
+typedef struct {
+    int tlogOffre; // Nombre de lignes (offres)
+    int *tDebut; // Ligne i : tColonnes[tDebut[i]] à tColonnes[tDebut[i + 1] - 1]
+    int *tColonnes; // Positions des candidats dans les tableaux des étudiants
+    IndexEtudiants index; // Numéro -> position des étudiants
+} MatriceCandidats;
+
+/**
+ * \brief Fichier des offres d'un département.
+ *
+ * Le manifeste garde, pour chaque département, le nombre de ses offres et
+ * l'intervalle de leurs références : une référence cherchée ne fait charger que
+ * les départements dont l'intervalle la contient.
+ */
+typedef struct {
+    int dpt; // Numéro du département
+    int modifie; // Version des données lors de la dernière modification du département
+    int sauve; // Version des données écrite dans le fichier
+    int charge; // 1 si les offres du département sont en mémoire
+    int nb; // Nombre d'offres du fichier (-1 : inconnu)
+    int refMin, refMax; // Intervalle des références du fichier (INT_MIN, INT_MAX : inconnu)
+} Shard;
+
+/**
+ * \brief Morceau d'un fichier de données analysé par un fil.
+ */
+typedef struct {
+    const char *debut, *fin; // Texte à analyser, aligné sur les enregistrements
+    int *tCol[7]; // Colonnes remplies par le fil
+    float *tNote; // Notes remplies par le fil (étudiants)
+    int tlog, tmax;
+    int depasse; // 1 si le morceau contient plus d'enregistrements que tmax
+} Morceau;
+
+/**
+ * \brief Tableaux à remplir par un fil de chargement.
+ */
+typedef struct {
+    Offres *o; // Offres à remplir (fil des offres)
+    Etudiants *e; // Étudiants à remplir (fil des étudiants)
+    int code; // Code de retour de la fonction de chargement (0 tant que non chargé)
+} Chargement;
+
+#define NB_DPT_FILTRE 16 // Départements au plus dans une liste "dpt=a,b,..."
+
+/**
+ * \brief Filtre de recherche des offres compilé : un intervalle par colonne.
+ *
+ * Exemple de texte : "dpt=15,63 pourvu=0 candid<2 ref=2000-3000" ; les critères
+ * séparés par des espaces doivent tous être vérifiés.
+ */
+typedef struct {
+    int refMin, refMax;
+    int dptMin, dptMax;
+    int pourvuMin, pourvuMax;
+    int candidMin, candidMax;
+    int nbDpt; // Nombre de départements de la liste (0 : pas de liste)
+    int tDpt[NB_DPT_FILTRE];
+} Filtre;
+
+#define POLITIQUE_NOTE 0 // Le candidat libre qui a la meilleure moyenne
+#define POLITIQUE_ORDRE 1 // Le premier candidat libre, dans l'ordre des candidatures
+#define POLITIQUE_HASARD 2 // Un candidat libre tiré au hasard
+#define NB_POLITIQUES 3
+#define TOURS_PAR_LOT 64 // Tours de simulation pris d'un coup par un fil
+
+/**
+ * \brief Simulation d'affectations partagée par les fils de calcul.
+ *
+ * Les fils lisent directement les colonnes d'un instantané épinglé, sans copie ;
+ * chacun ne possède que ses tableaux de travail.
+ */
+typedef struct {
+    Instantane *inst; // Données simulées (lecture seule)
+    int *tCandPos; // Positions des 3 candidats de chaque offre (-1 : aucun ou inconnu)
+    int politique;
+    int nbTours;
+    unsigned int graine;
+    int prochainTour; // Premier tour pas encore distribué
+    pthread_mutex_t verrou; // Protège prochainTour
+    int *tPourvus; // Nombre de stages pourvus à la fin de chaque tour
+    int *tSansStage; // Nombre d'étudiants sans stage à la fin de chaque tour
+} Simulation;
+
+#define VIOLATION_REF_STAGE 0 // Stage d'un étudiant absent des offres
+#define VIOLATION_NON_POURVU 1 // Étudiant affecté à une offre non pourvue
+#define VIOLATION_SANS_ETUDIANT 2 // Offre pourvue sans étudiant affecté
+#define VIOLATION_DOUBLE_AFFECTATION 3 // Offre affectée à plusieurs étudiants
+#define VIOLATION_CANDIDAT_INCONNU 4 // Candidat absent des étudiants
+#define VIOLATION_NB_CANDIDATS 5 // CANDID différent du nombre de candidats
+#define VIOLATION_REF_DOUBLE 6 // Référence présente plusieurs fois
+#define VIOLATION_NUM_DOUBLE 7 // Numéro d'étudiant présent plusieurs fois
+#define VIOLATION_ATTENTE_OFFRE 8 // Liste d'attente d'une offre inexistante ou pourvue
+#define VIOLATION_ATTENTE_PLACE 9 // Liste d'attente d'une offre qui a encore des places
+#define VIOLATION_ATTENTE_ETUDIANT 10 // Étudiant en attente inconnu ou déjà affecté
+#define VIOLATION_ATTENTE_DOUBLE 11 // Étudiant deux fois dans une file, ou en attente d'une offre où il est candidat
+#define NB_VIOLATIONS 12
+#define NB_EXEMPLES 5 // Exemples gardés par sorte de violation
+#define TRANCHE_VERIF_MIN (1 << 16) // Nombre minimal d'enregistrements vérifiés par un fil
+
+/**
+ * \brief Résultat d'une vérification des données : nombre de violations de chaque sorte.
+ */
+typedef struct {
+    long tNb[NB_VIOLATIONS];
+    int tExemples[NB_VIOLATIONS][NB_EXEMPLES]; // REF de l'offre ou NUM de l'étudiant en cause
+} Rapport;
+
+/**
+ * \brief Tranche des données vérifiée par un fil.
+ */
+typedef struct {
+    Stockage *s; // Données vérifiées (lecture seule)
+    IndexEtudiants *index; // Numéros des étudiants triés
+    int *tNbAffectes; // Nombre d'étudiants affectés à chaque offre (partagé)
+    int debut, fin; // Positions vérifiées
+    Rapport rapport; // Violations trouvées par le fil
+} Verification;
+
+// Remplir Tableaux
+    char *chargerFichier(const char *chemin, long *taille);
+    int lireEntierTexte(const char **p, const char *fin, int *val);
+    int lireReelTexte(const char **p, const char *fin, float *val);
+    void *analyserMorceauOffres(void *arg);
+    void *analyserMorceauEtudiants(void *arg);
+    int estDebutOffre(const char *p, const char *fin);
+    const char *debutEnregistrement(const char *p, const char *fin, int offres);
+    int nbFilsChargement(long taille);
+    int analyserTexte(const char *texte, long taille, Offres *o, Etudiants *e);
+    int lireFichierOffres(const char *chemin, Offres *o);
+    int remplirOffreStage(Offres *o);
+    int remplirListeEtudiants(Etudiants *e);
+    int lireFichierEtudiants(const char *chemin, Etudiants *e);
+    void *chargerOffres(void *arg);
+    void *chargerEtudiants(void *arg);
+
+// Colonnes compactes
+    int pourvuOffre(Offres *o, int i);
+    void fixerPourvu(Offres *o, int i, int pourvu);
+    int candidOffre(Offres *o, int i);
+    void fixerCandid(Offres *o, int i, int nb);
+    int dptOffre(Offres *o, int i);
+    void fixerDpt(Offres *o, int i, int dpt);
+    float noteEtudiant(Etudiants *e, int i);
+    void fixerNote(Etudiants *e, int i, float note);
+    int noteRepresentable(float note);
+    void lireLigneOffre(Offres *o, int i, int tLigne[]);
+    void ecrireLigneOffre(Offres *o, int i, int tLigne[]);
+    int allouerOffres(Offres *o, int tmax);
+    void libererOffres(Offres *o);
+    int allouerEtudiants(Etudiants *e, int tmax);
+    void libererEtudiants(Etudiants *e);
+
+// Stockage
+    int creerStockage(Stockage *s, int tmaxOffre, int tmaxEtu);
+    int creerStockageDonnees(Stockage *s, int margeOffres);
+    void libererStockage(Stockage *s);
+    int chargerStockage(Stockage *s);
+    int ajouterOffre(Stockage *s, int ref, int dpt);
+    int supprimerOffre(Stockage *s, int ref);
+    int candidaterOffre(Stockage *s, int ref, int etu);
+    int affecterOffre(Stockage *s, int ref, int etu);
+    int noterEtudiant(Stockage *s, int num, float moyenne);
+
+// Index des références
+    int trierOffres(Offres *o);
+    int rechercheDichoRef(int tRef[], int tlog, int ref, int *trouve);
+    int successeurRef(int tRef[], int tlog, int ref);
+    int predecesseurRef(int tRef[], int tlog, int ref);
+    int prochaineRefLibre(int tRef[], int tlog, int ref);
+
+// Sauvegarde
+    void ecrireOffre(FILE *flot, Offres *o, int i);
+    FILE *ouvrirTemporaire(const char *chemin);
+    int publierTemporaire(FILE *flot, const char *chemin, int valider);
+    void synchroniserDossier(const char *dossier);
+    int ecrireFichiers(Offres *o, Etudiants *e, int tAttente[], int lgAttente, int complet, int versionEcrite);
+    int modificationFichier(Stockage *s);
+
+// Sauvegarde concurrente
+    int verrouillerDonnees(int mode);
+    void deverrouillerDonnees(int fd);
+    int lireEstampille(void);
+    int ecrireEstampille(int estampille);
+    void noterModification(int offre, int cle, int champ, int tAvant[], float noteAvant);
+    int comparerModifications(const void *a, const void *b);
+    int chargerDisque(Stockage *d, int margeOffres);
+    int contientCandidat(int t[], int nb, int etu);
+    int fusionnerOffre(Offres *o, Modification *base, Offres *session);
+    int fusionnerEtudiant(Etudiants *e, IndexEtudiants *index, Modification tGroupe[], int nb, Etudiants *session);
+    int fusionnerAttente(Stockage *d, Attentes *session, Modification tGroupe[], int nb);
+    int fusionnerModifications(Stockage *d, Modification tModifs[], int nb, Offres *o, Etudiants *e, int tAttente[], int lgAttente);
+    int sauvegarderDonnees(Offres *o, Etudiants *e, int tAttente[], int lgAttente, int versionEcrite);
+
+// Découpage par département
+    int lireManifeste(void);
+    int ajouterShard(int dpt, int charge);
+    void marquerShardModifie(int dpt);
+    int ecrireShards(Offres *o, int tous, int complet, int versionEcrite);
+    int decouperOffres(void);
+    int lireLigneManifeste(FILE *flot, Shard *sh);
+    int chargerShards(Stockage *s, int dpt, int refMin, int refMax);
+    int chargerDepartement(Stockage *s, int dpt);
+    int chargerPlageRef(Stockage *s, int refMin, int refMax);
+    int chargerToutesOffres(Stockage *s);
+    int offreHorsMemoire(int ref);
+    int departementsNonCharges(void);
+
+// Sauvegarde automatique
+    int sauvegarderInstantane(void);
+    void *boucleSauvegarde(void *arg);
+    int demarrerSauvegardeAuto(void);
+    int demanderSauvegarde(void);
+    int echecsSauvegardeAuto(int *cause);
+    void arreterSauvegardeAuto(void);
+
+// Transactions
+    void debutTransaction(void);
+    void validerTransaction(void);
+    int journaliser(EntreeJournal entree);
+    void journaliserOffre(int type, int pos, Offres *o);
+    void journaliserEtudiant(int type, int pos, int refStage, float note);
+    void retirerOffre(Offres *o, int pos);
+    int annulerTransaction(Stockage *s);
+
+// Instantanés
+    void marquerModification(void);
+    int versionDonnees(void);
+    int centiemes(float note);
+    Instantane *creerInstantane(Stockage *s);
+    int publierInstantane(Stockage *s);
+    Instantane *epinglerInstantane(void);
+    void libererInstantane(Instantane *inst);
+
+// Flux d'événements
+    long dernierNumeroEvenement(void);
+    int ouvrirEvenements(void);
+    int ecrireEvenements(char tLignes[], int lg);
+    void emettreEvenement(const char *format, ...);
+    int publierEvenements(void);
+
+// Index des étudiants
+    int comparerCles(const void *a, const void *b);
+    int indexerEtudiants(IndexEtudiants *ix, int tNumEtu[], int tlogEtu);
+    void libererIndex(IndexEtudiants *ix);
+    int indiceEtudiant(IndexEtudiants *ix, int num);
+
+// Matrice des candidatures
+    int construireMatrice(MatriceCandidats *m, Offres *o, Etudiants *e);
+    void libererMatrice(MatriceCandidats *m);
+    int nbCandidatsLigne(MatriceCandidats *m, int pos);
+    int offresCandidatSansStage(MatriceCandidats *m, int tRefStage[], int tOffres[], int tNb[]);
+
+// Listes d'attente
+    void attentesInit(Attentes *a);
+    void libererAttentes(Attentes *a);
+    int fileAttente(Attentes *a, int ref, int creer);
+    int prendreMaillon(Attentes *a);
+    int insererAttente(Attentes *a, int ref, int etu, int rang);
+    int retirerAttente(Attentes *a, int ref, int rang);
+    int rangAttente(Attentes *a, int ref, int etu);
+    int listeAttente(Attentes *a, int ref, int tEtu[], int max);
+    int aplatirAttentes(Attentes *a, int **tAttente, int *lgAttente);
+    int chargerAttentesTableau(Attentes *a, int tAttente[], int lgAttente);
+    int violationFile(Offres *o, int ref, int complet);
+    int lireFichierAttente(const char *chemin, Stockage *s, int complet);
+    int ecrireFichierAttente(int tAttente[], int lgAttente);
+    void journaliserAttente(int type, int ref, int etu, int rang);
+    int mettreEnAttente(Stockage *s, int ref, int etu);
+    void promouvoirAttente(Stockage *s, int pos);
+    void viderAttente(Stockage *s, int ref);
+    void oublierAttentes(Stockage *s, int etu);
+
+// Requêtes
+    void construireAffectations(Offres *o, Etudiants *e, int tEtuAffecte[]);
+    void decalerAdroite(Offres *o, int pos);
+    int rechercherEtudiant(int tNumEtu[], int tlogEtu, int id);
+    void descendreTas(int tTas[], int taille, int i, Etudiants *e);
+    int meilleursSansStage(Etudiants *e, int k, int tMeilleurs[]);
+    int offresDuDepartement(Offres *o, int dpt, int tPos[]);
+
+// Filtre des offres
+    void filtreInit(Filtre *f);
+    void restreindre(int *min, int *max, int bas, int haut);
+    int lireValeurFiltre(const char **p, int *val);
+    void restreindreListe(Filtre *f, int tListe[], int nb);
+    int compilerFiltre(const char *texte, Filtre *f);
+    int filtrerOffres(Offres *o, Filtre *f, int tPos[]);
+
+// Simulation d'affectations
+    int tourSimulation(Simulation *sim, int tour, char tPlace[], int tOrdre[]);
+    void *filSimulation(void *arg);
+    int simulerAffectations(Instantane *inst, int politique, int nbTours, unsigned int graine, int tPourvus[], int tSansStage[]);
+    void resumerSerie(int t[], int nb, int *min, int *max, double *moyenne);
+
+// Vérification des données
+    void signalerViolation(Rapport *r, int sorte, int cle);
+    void *verifierTrancheEtudiants(void *arg);
+    void *verifierTrancheOffres(void *arg);
+    void lancerVerification(Verification tTranches[], int nbFils, void *(*verifier)(void *));
+    void verifierAttentes(Stockage *s, IndexEtudiants *index, Rapport *r);
+    long verifierDonnees(Stockage *s, Rapport *r);
+
+// Comparaison de deux versions
+    int lireDepartementsManifeste(FILE *flot, const char *dossier, int **tDpts, long *tailleOffres);
+    int chargerDossier(Stockage *s, const char *dossier, int margeOffres);
+    long comparerOffres(Offres *a, Offres *b, FILE *flot);
+    long comparerEtudiants(Etudiants *a, Etudiants *b, FILE *flot);
+    int memeFile(Attentes *a, int fa, Attentes *b, int fb);
+    long comparerAttentes(Attentes *a, Attentes *b, FILE *flot);
+    long comparerDossiers(const char *dossierA, const char *dossierB, FILE *flot);
+
+#endif
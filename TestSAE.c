@@ -8,8 +8,97 @@
 
 /**
  * \brief Permet de lancer le programme.
+ *
+ * Options :
+ * - "--decouper" : découpe "offrestage.don" en un fichier par département ;
+ * - "--verifier" : vérifie la cohérence des données et affiche les violations
+ *   (code de sortie 1 s'il y en a) ;
+ * - "--diff DOSSIER_A DOSSIER_B" : écrit les changements entre deux versions des
+ *   données (code de sortie 1 s'il y en a, comme diff) ;
+ * - "--enregistrer FICHIER" : enregistre toutes les saisies de la session ;
+ * - "--rejouer [--max] FICHIER..." : rejoue un ou plusieurs enregistrements
+ *   (en parallèle s'il y en a plusieurs), à vitesse réelle ou maximale avec "--max".
+ *
+ * \param argc Nombre d'arguments.
+ * \param argv Arguments de la ligne de commande.
  */
-int main(void) {
+int main(int argc, char *argv[]) {
+    int code;
+
+    if (argc > 1 && strcmp(argv[1], "--decouper") == 0) {
+        code = decouperOffres();
+        if (code == -1) {
+            printf("\nUne erreur est survenue lors du découpage des offres !\n");
+            return 1;
+        }
+        printf("\n%d fichier(s) de département écrit(s) dans %s.\n", code, DOSSIER_SHARDS);
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--verifier") == 0) {
+        Stockage s;
+        Rapport rapport;
+        long nbViolations;
+
+        // Toutes les offres, même celles des départements découpés
+        if (creerStockageDonnees(&s, 0) == -1 || chargerStockage(&s) < 0 || chargerToutesOffres(&s) != 1) {
+            printf("\nImpossible de charger les données !\n");
+            return 2;
+        }
+        nbViolations = verifierDonnees(&s, &rapport);
+        libererStockage(&s);
+        if (nbViolations == -1) {
+            printf("\nMémoire insuffisante !\n");
+            return 2;
+        }
+        printf("\n%ld incohérence(s) trouvée(s).", nbViolations);
+        afficherRapport(&rapport);
+        return nbViolations == 0 ? 0 : 1;
+    }
+
+    if (argc > 3 && strcmp(argv[1], "--diff") == 0) {
+        long nbChangements = comparerDossiers(argv[2], argv[3], stdout);
+
+        if (nbChangements == -1 || nbChangements == -2) {
+            fprintf(stderr, "\nImpossible de charger les données de %s !\n", nbChangements == -1 ? argv[2] : argv[3]);
+            return 2;
+        }
+        if (nbChangements == -3) {
+            fprintf(stderr, "\nMémoire insuffisante !\n");
+            return 2;
+        }
+        return nbChangements == 0 ? 0 : 1;
+    }
+
+    if (argc > 2 && strcmp(argv[1], "--enregistrer") == 0) {
+        if (demarrerEnregistrement(argv[2]) == -1) {
+            printf("\nImpossible de créer le fichier d'enregistrement !\n");
+            return 1;
+        }
+        global();
+        terminerSaisies();
+        return 0;
+    }
+
+    if (argc > 2 && strcmp(argv[1], "--rejouer") == 0) {
+        int vitesseMax = strcmp(argv[2], "--max") == 0;
+        int premier = vitesseMax ? 3 : 2;
+
+        if (argc - premier > 1) return rejouerPlusieurs(argc - premier, argv + premier, vitesseMax) == 1 ? 0 : 1;
+        code = argc - premier < 1 ? -1 : demarrerRejeu(argv[premier], vitesseMax);
+        if (code == -1) {
+            printf("\nImpossible de lire l'enregistrement !\n");
+            return 1;
+        }
+        if (code == -2) {
+            printf("\nEnregistrement d'une autre version des menus, rejeu impossible !\n");
+            return 1;
+        }
+        global();
+        terminerSaisies();
+        return 0;
+    }
+
     global();
     return 0;
 }
\ No newline at end of file